@@ -0,0 +1,188 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <iomanip>
+#include <fstream>
+#include "BatchAnalysis.h"
+#include "OrderedParallel.h"
+
+/// <summary>
+/// AnalysisJob is a line of input on its way through the worker threads: the position as written, the board and the outcome of its analysis
+/// </summary>
+struct AnalysisJob {
+	enum t_Kind { POSITION, INVALID, FINISHED };
+
+	std::string position;
+	Board board;
+	t_Kind kind = POSITION;
+	Move move = 0;
+	int score = 0;
+	unsigned long long nodes = 0;
+	double time_ms = 0.0;
+};
+
+/// <summary>
+/// AnalyzePositions() finds the best move of every position read from a stream, and writes one line per position, in input order:
+///   position <tab> best move <tab> score <tab> nodes <tab> time (ms)
+/// The input is read as by ParsePositions() (one position per line, as moves or as a position string; blank lines and '#' lines are skipped).
+/// A position that is not valid is written as "position <tab> invalid", and one in which the game is already over as "position <tab> over".
+/// The positions are read as the workers need them and written as soon as every earlier position has been written: with nThreads workers, at 
+/// most 16 * nThreads positions are held at any time, whatever the size of the input.  Each worker searches with its own clone of the solver;
+/// the clones share the solver's root search cache, if it has one (see Solver_ConnectFour::EnableSolveCache()), so positions that repeat are
+/// only searched once.
+/// </summary>
+/// <param name="solver">Solver (with one thread, used directly; otherwise cloned for each worker)</param>
+/// <param name="in">Positions</param>
+/// <param name="out">Stream to which the results are written</param>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread)</param>
+/// <param name="summary">If not null, returns the totals of the analysis</param>
+/// <returns>false if the results could not all be written</returns>
+bool AnalyzePositions(Solver_ConnectFour* solver, std::istream& in, std::ostream& out, unsigned int nThreads, AnalysisSummary* summary) {
+	AnalysisSummary totals;
+	auto c_start = std::chrono::steady_clock::now();
+
+	if (nThreads == 0)
+		nThreads = DefaultNumberOfThreads();
+	std::vector<std::unique_ptr<Solver_ConnectFour>> solvers;
+	for (unsigned int w = 0; (w < nThreads) && (nThreads > 1); w++) {
+		solvers.emplace_back(solver->Clone());
+	}
+
+	out << "# position\tmove\tscore\tnodes\ttime_ms" << "\n";
+	out << std::fixed << std::setprecision(3);
+
+	std::string line;
+	std::vector<Board> parsed;
+	RunOrdered<AnalysisJob, AnalysisJob>(nThreads, 16 * (size_t)nThreads,
+		// next position (skipping blank lines and comments)
+		[&](AnalysisJob& job) {
+			while (std::getline(in, line)) {
+				size_t nInvalid = 0;
+				parsed.clear();
+				ParsePositions(line.data(), line.size(), parsed, &nInvalid);
+				if (parsed.empty() && (nInvalid == 0))
+					continue;
+
+				job.position.assign(line, 0, line.find_first_of(" \t\r"));
+				job.kind = parsed.empty() ? AnalysisJob::INVALID : AnalysisJob::POSITION;
+				if (!parsed.empty())
+					job.board = parsed[0];
+				return true;
+			}
+			return false;
+		},
+		// search the position on worker w
+		[&](unsigned int w, AnalysisJob& job) {
+			if (job.kind == AnalysisJob::INVALID)
+				return job;
+			Board& b = job.board;
+			if (b.IsNoMove() || b.IsWin((typePlayer)!b.GetPlayerToMove())) {
+				job.kind = AnalysisJob::FINISHED;
+				return job;
+			}
+
+			Solver_ConnectFour* p = (nThreads > 1) ? solvers[w].get() : solver;
+			unsigned long long nodes = p->GetNumberOfNodes();
+			auto t_start = std::chrono::steady_clock::now();
+			job.move = p->SolveBoard(b, b.NumberOfMoves());
+			job.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t_start).count();
+			job.score = p->GetLastScore();
+			job.nodes = p->GetNumberOfNodes() - nodes;
+			return job;
+		},
+		// write the results in input order
+		[&](size_t, AnalysisJob& job) {
+			out << job.position;
+			switch (job.kind) {
+			case AnalysisJob::INVALID:
+				out << "\tinvalid\n";
+				totals.invalid++;
+				break;
+			case AnalysisJob::FINISHED:
+				out << "\tover\n";
+				totals.finished++;
+				break;
+			default:
+				out << "\t" << job.move << "\t" << job.score << "\t" << job.nodes << "\t" << job.time_ms << "\n";
+				totals.positions++;
+				totals.nodes += job.nodes;
+				totals.search_ms += job.time_ms;
+				break;
+			}
+			return (bool)out;
+		});
+	out.flush();
+
+	totals.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - c_start).count();
+	if (summary)
+		*summary = totals;
+	return (bool)out;
+}
+
+/// <summary>
+/// AnalyzePositionFile() analyzes a file of positions (see AnalyzePositions())
+/// </summary>
+/// <param name="solver">Solver</param>
+/// <param name="inFile">Position file ("-" = standard input)</param>
+/// <param name="outFile">Results file ("-" = standard output)</param>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread)</param>
+/// <param name="summary">If not null, returns the totals of the analysis</param>
+/// <returns>false if a file cannot be opened or the results could not all be written</returns>
+bool AnalyzePositionFile(Solver_ConnectFour* solver, const std::string& inFile, const std::string& outFile, unsigned int nThreads, AnalysisSummary* summary) {
+	std::ifstream inStream;
+	std::ofstream outStream;
+	if (inFile != "-") {
+		inStream.open(inFile, std::ios::binary);
+		if (!inStream) {
+			std::cerr << "Cannot open position file " << inFile << std::endl;
+			return false;
+		}
+	}
+	if (outFile != "-") {
+		outStream.open(outFile, std::ios::binary);
+		if (!outStream) {
+			std::cerr << "Cannot create results file " << outFile << std::endl;
+			return false;
+		}
+	}
+	std::istream& in = (inFile != "-") ? inStream : std::cin;
+	std::ostream& out = (outFile != "-") ? outStream : std::cout;
+	return AnalyzePositions(solver, in, out, nThreads, summary);
+}
+
+/// <summary>
+/// PrintAnalysisSummary() displays the totals of a batch analysis
+/// </summary>
+/// <param name="summary">Totals returned by AnalyzePositions()</param>
+/// <param name="out">Stream to display them on (e.g., std::cerr, when the results are written to the standard output)</param>
+void PrintAnalysisSummary(const AnalysisSummary& summary, std::ostream& out) {
+	double seconds = summary.elapsed_ms / 1000.0;
+	out << "Positions Analyzed: " << summary.positions << std::endl;
+	if (summary.finished != 0)
+		out << "Positions Already Over: " << summary.finished << std::endl;
+	if (summary.invalid != 0)
+		out << "Invalid Positions: " << summary.invalid << std::endl;
+	out << "Nodes: " << summary.nodes << std::endl;
+	out << "Time: " << std::fixed << std::setprecision(3) << seconds << " s (searching: " << summary.search_ms / 1000.0 << " s)" << std::endl;
+	if (seconds > 0.0) {
+		out << std::setprecision(0) << "Positions per Second: " << summary.positions / seconds << std::endl;
+		out << "Nodes per Second: " << summary.nodes / seconds << std::endl;
+	}
+	out << std::defaultfloat;
+}
@@ -0,0 +1,38 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <string>
+#include <iostream>
+#include "Solver_ConnectFour.h"
+
+/// <summary>
+/// AnalysisSummary sums up a batch analysis (see AnalyzePositions())
+/// </summary>
+struct AnalysisSummary {
+	size_t positions = 0;		// positions analyzed (written with a best move)
+	size_t invalid = 0;			// lines that are not valid positions
+	size_t finished = 0;		// positions in which the game is already over (won or board full)
+	unsigned long long nodes = 0;
+	double search_ms = 0.0;		// time spent searching, summed over the positions (exceeds the elapsed time with several threads)
+	double elapsed_ms = 0.0;
+};
+
+// Batch analysis
+bool AnalyzePositions(Solver_ConnectFour* solver, std::istream& in, std::ostream& out, unsigned int nThreads = 0, AnalysisSummary* summary = nullptr);
+bool AnalyzePositionFile(Solver_ConnectFour* solver, const std::string& inFile, const std::string& outFile, unsigned int nThreads = 0, 
+	AnalysisSummary* summary = nullptr);
+void PrintAnalysisSummary(const AnalysisSummary& summary, std::ostream& out);
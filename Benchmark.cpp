@@ -0,0 +1,731 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "FastRandom.h"
+#include "MinimaxPlay_Solver.h"
+#include "MinimaxABPlay_Solver.h"
+#include "OrderedParallel.h"
+
+//
+// Micro-benchmarks
+//
+
+/// <summary>
+/// BenchmarkIsWin() compares IsWinBatch() (scalar, AVX2 and AVX-512 paths) against a loop over Board::IsWin().  The positions are 
+/// generated by random play, stopping after a random number of moves, so that both won and not-won bitboards are tested.
+/// Every path is also checked against Board::IsWin().
+/// </summary>
+/// <param name="n">Number of positions</param>
+/// <param name="nRepeats">Number of times each path evaluates all positions</param>
+void BenchmarkIsWin(size_t n, unsigned int nRepeats) {
+	std::vector<Board> boards(n);
+	std::vector<typePlayer> players(n);
+	std::vector<BitBoard> bitboards(n);
+	std::vector<uint8_t> expected(n), out(n);
+	FastRandom rng(2023);
+
+	std::cout << "Benchmarking IsWin on " << n << " positions (" << nRepeats << " repeats)\n";
+
+	// Generate the positions
+	for (size_t i = 0; i < n; i++) {
+		Board& b = boards[i];
+		typePlayer p = RED;
+		unsigned int nMoves = 1 + rng.NextBounded(WIDTH * HEIGHT);
+		b.InitBoard(RED);
+		for (unsigned int k = 0; k < nMoves; k++) {
+			Move m = b.MoveSequence[rng.NextBounded(WIDTH)];
+			if (!b.IsValidMove(m))
+				continue;
+			b.MakeMove(m, p);
+			if (b.IsWin(p))
+				break;
+			p = (typePlayer)!p;
+		}
+		players[i] = p;
+		bitboards[i] = b.GetBoard(p);
+	}
+
+	// Loop over Board::IsWin()
+	unsigned long long nWins = 0;
+	auto c_start = std::chrono::steady_clock().now();
+	for (unsigned int r = 0; r < nRepeats; r++) {
+		for (size_t i = 0; i < n; i++) {
+			expected[i] = boards[i].IsWin(players[i]) ? 1 : 0;
+		}
+	}
+	auto c_end = std::chrono::steady_clock().now();
+	double baseline = std::chrono::duration<double>(c_end - c_start).count();
+	for (size_t i = 0; i < n; i++) {
+		nWins += expected[i];
+	}
+	std::cout << " Won positions : " << nWins << "\n";
+	std::cout << " Board::IsWin loop : " << (double)n * nRepeats / baseline / 1e6 << " M boards/sec\n";
+
+	// IsWinBatch() on every instruction set this CPU supports
+	t_SimdLevel levels[] = { SIMD_SCALAR, SIMD_AVX2, SIMD_AVX512 };
+	for (t_SimdLevel level : levels) {
+		if (ResolveSimdLevel(level) != level) {
+			std::cout << " IsWinBatch (" << SimdLevelName(level) << ") : not supported on this CPU\n";
+			continue;
+		}
+		c_start = std::chrono::steady_clock().now();
+		for (unsigned int r = 0; r < nRepeats; r++) {
+			IsWinBatch(bitboards.data(), n, out.data(), level);
+		}
+		c_end = std::chrono::steady_clock().now();
+		double seconds = std::chrono::duration<double>(c_end - c_start).count();
+
+		size_t mismatches = 0;
+		for (size_t i = 0; i < n; i++) {
+			if (out[i] != expected[i])
+				mismatches++;
+		}
+		std::cout << " IsWinBatch (" << SimdLevelName(level) << ") : " << (double)n * nRepeats / seconds / 1e6 << " M boards/sec, speedup " 
+			<< baseline / seconds << "x" << (mismatches ? ", MISMATCHES: " : "") ;
+		if (mismatches)
+			std::cout << mismatches;
+		std::cout << "\n";
+	}
+}
+
+//
+// Perft (move generation)
+//
+
+// Perft of the empty board (RED to move) at depths 0, 1, 2, ... (checked against an independent bitboard implementation)
+static const unsigned long long perftReference[] = { 1ULL, 7ULL, 49ULL, 343ULL, 2401ULL, 16807ULL, 117649ULL, 823536ULL, 5673234ULL, 39394572ULL,
+	268031646ULL, 1844590828ULL };
+
+/// <summary>
+/// Perft() counts the move sequences of exactly depth moves from a position, using only Board::IsValidMove(), MakeMove(), IsWin() and 
+/// TakeBackMove().  A game ends at a win: a winning move is counted if it is the last move of the sequence, and is not played on from.
+/// </summary>
+/// <param name="b">Position (restored on return)</param>
+/// <param name="p">Player to move</param>
+/// <param name="depth">Number of moves</param>
+/// <returns>Number of leaves</returns>
+unsigned long long Perft(Board& b, typePlayer p, unsigned int depth) {
+	if (depth == 0)
+		return 1;
+
+	unsigned long long leaves = 0;
+	for (Move m = 1; m <= WIDTH; m++) {
+		if (!b.IsValidMove(m))
+			continue;
+		b.MakeMove(m, p);
+		if (b.IsWin(p))
+			leaves += (depth == 1) ? 1 : 0;
+		else
+			leaves += Perft(b, (typePlayer)!p, depth - 1);
+		b.TakeBackMove(m, p);
+	}
+	return leaves;
+}
+
+/// <summary>
+/// PerftSplit() collects the positions reached after 'ply' moves (games won before that are dropped), to be searched in parallel
+/// </summary>
+static void PerftSplit(Board& b, typePlayer p, unsigned int ply, std::vector<std::pair<Board, typePlayer>>& positions) {
+	if (ply == 0) {
+		positions.push_back(std::make_pair(b, p));
+		return;
+	}
+	for (Move m = 1; m <= WIDTH; m++) {
+		if (!b.IsValidMove(m))
+			continue;
+		b.MakeMove(m, p);
+		if (!b.IsWin(p))
+			PerftSplit(b, (typePlayer)!p, ply - 1, positions);
+		b.TakeBackMove(m, p);
+	}
+}
+
+/// <summary>
+/// PerftParallel() is Perft() split across threads: the positions two moves from the root (up to 49) are shared out between the threads
+/// </summary>
+/// <param name="b">Position</param>
+/// <param name="p">Player to move</param>
+/// <param name="depth">Number of moves</param>
+/// <param name="nThreads">Number of threads (0 = one per hardware thread)</param>
+/// <returns>Number of leaves</returns>
+unsigned long long PerftParallel(const Board& b, typePlayer p, unsigned int depth, unsigned int nThreads) {
+	Board root = b;
+	if (nThreads == 0)
+		nThreads = DefaultNumberOfThreads();
+	if ((nThreads == 1) || (depth <= 2))
+		return Perft(root, p, depth);
+
+	// Wins within the first two moves end before the leaves (depth > 2), so they add nothing
+	std::vector<std::pair<Board, typePlayer>> positions;
+	PerftSplit(root, p, 2, positions);
+
+	unsigned long long leaves = 0;
+	size_t next = 0;
+	RunOrdered<size_t, unsigned long long>(nThreads, positions.size(),
+		[&](size_t& job) {
+			if (next >= positions.size())
+				return false;
+			job = next++;
+			return true;
+		},
+		[&](unsigned int, size_t& job) {
+			Board position = positions[job].first;
+			return Perft(position, positions[job].second, depth - 2);
+		},
+		[&](size_t, unsigned long long& n) {
+			leaves += n;
+			return true;
+		});
+	return leaves;
+}
+
+/// <summary>
+/// BenchmarkPerft() runs perft at depths 1 thru maxDepth from a position, reporting the leaves, the time and the leaves per second.
+/// From the empty board, the counts are checked against the reference counts.
+/// </summary>
+/// <param name="moves">Position, as the moves played from the empty board ("" = empty board)</param>
+/// <param name="maxDepth">Deepest perft</param>
+/// <param name="nThreads">Number of threads (0 = one per hardware thread)</param>
+/// <returns>false if the position is not valid or a count does not match the reference</returns>
+bool BenchmarkPerft(const std::string& moves, unsigned int maxDepth, unsigned int nThreads) {
+	Board b;
+	if (!Board::FromMoves(moves, b) || b.IsWin((typePlayer)!b.GetPlayerToMove())) {
+		std::cout << "Invalid position: " << moves << std::endl;
+		return false;
+	}
+	typePlayer p = (moves.size() % 2 == 0) ? RED : YELLOW;
+	bool bCorrect = true;
+
+	std::cout << "Perft from " << (moves.empty() ? "the empty board" : moves) << " (" << ((nThreads == 0) ? DefaultNumberOfThreads() : nThreads) 
+		<< " threads)\n";
+	std::cout << std::setw(6) << "Depth" << std::setw(16) << "Leaves" << std::setw(12) << "ms" << std::setw(16) << "Leaves/sec" << std::endl;
+	for (unsigned int depth = 1; depth <= maxDepth; depth++) {
+		auto c_start = std::chrono::steady_clock::now();
+		unsigned long long leaves = PerftParallel(b, p, depth, nThreads);
+		auto c_end = std::chrono::steady_clock::now();
+		double ms = std::chrono::duration<double, std::milli>(c_end - c_start).count();
+
+		std::cout << std::setw(6) << depth << std::setw(16) << leaves << std::fixed << std::setprecision(1) << std::setw(12) << ms << std::setprecision(0) 
+			<< std::setw(16) << ((ms > 0) ? 1000.0 * leaves / ms : 0.0);
+		std::cout.unsetf(std::ios::fixed);
+		std::cout << std::setprecision(6);
+		if (moves.empty() && (depth < sizeof(perftReference) / sizeof(perftReference[0]))) {
+			if (leaves == perftReference[depth]) {
+				std::cout << "  OK";
+			}
+			else {
+				std::cout << "  MISMATCH (expected " << perftReference[depth] << ")";
+				bCorrect = false;
+			}
+		}
+		std::cout << std::endl;
+	}
+	return bCorrect;
+}
+
+//
+// Position suites
+//
+
+/// <summary>
+/// BenchPosition is a position of a benchmark suite, written as the moves played from the empty board, with the score of the side to move
+/// at the suite's depth.  The end-easy scores are exact game results (the search reaches the end of the game); the other scores are those 
+/// of the minimax solvers at the suite's depth (minimax and alpha-beta agree), so they catch any change to what the search computes.
+/// The side to move has no immediate win in any position.  Apart from two end-easy draws, every score is a win or a loss within the suite's
+/// depth, so a search that stops early or misses a threat cannot pass by returning the draw score.
+/// </summary>
+struct BenchPosition {
+	const char* moves;
+	int score;
+};
+
+static const BenchPosition benchEndEasy[] = {
+	{ "25632221546427362713654561633", 0 },
+	{ "1346313635714327446667623442", 8 },
+	{ "622771151227244216664757765114", -8 },
+	{ "23555671165743722261276617133567", 6 },
+	{ "42253352557267361631367273672", -4 },
+	{ "6575733317721115537136263256", -9 },
+	{ "56534171656767266524521132445", 7 },
+	{ "3716421321232264427436141553415", 7 },
+	{ "23612171751214422717442666647", 6 },
+	{ "35761754467311371555326671657614", 5 },
+	{ "5457552474712636572232426756137", 0 },
+	{ "71164565557525731111672766624", -8 },
+};
+
+static const BenchPosition benchMiddleMedium[] = {
+	{ "72122641646577514", -12 },
+	{ "37156246142214262", 12 },
+	{ "674453746163777", 13 },
+	{ "66722533767547534", 13 },
+	{ "62135644473564", -16 },
+	{ "1452453112617", 16 },
+	{ "76743733727745416", -13 },
+	{ "45635123324351", 15 },
+	{ "3647354244643513", 14 },
+	{ "5664477544242575", -14 },
+	{ "77325324241532357", 14 },
+	{ "23416312751327", -15 },
+};
+
+static const BenchPosition benchBeginHard[] = {
+	{ "3753", 20 },
+	{ "414733", 19 },
+	{ "422241", 15 },
+	{ "42222111", 16 },
+	{ "67525762", 14 },
+	{ "3747263", -19 },
+	{ "4746374", -18 },
+	{ "26473", -20 },
+};
+
+struct BenchSuite {
+	const char* name;
+	unsigned int depth;
+	const BenchPosition* positions;
+	size_t n;
+};
+
+static const BenchSuite benchSuites[] = {
+	{ "end-easy", 14, benchEndEasy, sizeof(benchEndEasy) / sizeof(benchEndEasy[0]) },
+	{ "middle-medium", 8, benchMiddleMedium, sizeof(benchMiddleMedium) / sizeof(benchMiddleMedium[0]) },
+	{ "begin-hard", 11, benchBeginHard, sizeof(benchBeginHard) / sizeof(benchBeginHard[0]) },
+};
+
+/// <summary>
+/// Median() returns the median of a set of values (0 if there are none)
+/// </summary>
+static double Median(std::vector<double> values) {
+	if (values.empty())
+		return 0.0;
+	size_t n = values.size();
+	std::sort(values.begin(), values.end());
+	return (n % 2 == 1) ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+/// <summary>
+/// MedianAbsoluteDeviation() returns the median of the distances to the median: a measure of the noise of repeated timings that, unlike the
+/// standard deviation, is not thrown off by the odd run disturbed by the rest of the system
+/// </summary>
+static double MedianAbsoluteDeviation(const std::vector<double>& values) {
+	double median = Median(values);
+	std::vector<double> deviations;
+	for (double v : values) {
+		deviations.push_back(std::fabs(v - median));
+	}
+	return Median(deviations);
+}
+
+/// <summary>
+/// RunBenchmarkSuites() solves every position of the built-in suites and checks the scores.  Each suite is run nRepeats times; its time is the
+/// median over the runs, with the median absolute deviation as its noise.  Node counts come from the search statistics (0 if they are compiled out)
+/// and must be the same in every run, as the searches are deterministic.
+/// </summary>
+/// <param name="solver">"ab" (MinimaxABPlay_Solver) or "minimax" (MinimaxPlay_Solver)</param>
+/// <param name="depth">Search depth (0 = the depth of each suite; the scores are only checked at that depth)</param>
+/// <param name="results">Returns one result per suite</param>
+/// <param name="bPerfCounters">Also count hardware events (see PerfCounters.h) over the searches of the first run</param>
+/// <param name="nRepeats">Number of runs of each suite</param>
+/// <returns>false if the solver is unknown, a score did not match, or the node counts changed between runs</returns>
+bool RunBenchmarkSuites(const std::string& solver, unsigned int depth, std::vector<BenchSuiteResult>& results, bool bPerfCounters, unsigned int nRepeats) {
+	bool bCorrect = true;
+	results.clear();
+	if (nRepeats == 0)
+		nRepeats = 1;
+
+	std::unique_ptr<PerfCounters> counters;
+	if (bPerfCounters) {
+		counters.reset(new PerfCounters());
+		if (!counters->IsAvailable()) {
+			std::cout << "Hardware counters not available: " << counters->GetError() << std::endl;
+			counters.reset();
+		}
+	}
+
+	for (const BenchSuite& suite : benchSuites) {
+		BenchSuiteResult r;
+		r.name = suite.name;
+		r.depth = (depth == 0) ? suite.depth : depth;
+		r.positions = suite.n;
+		r.bVerified = (r.depth == suite.depth);
+
+		std::unique_ptr<Solver_ConnectFour> p;
+		if (solver == "ab")
+			p.reset(new MinimaxABPlay_Solver(r.depth, false));
+		else if (solver == "minimax")
+			p.reset(new MinimaxPlay_Solver(r.depth, false));
+		else {
+			std::cout << "Unknown solver " << solver << " (ab, minimax)" << std::endl;
+			return false;
+		}
+
+		for (unsigned int run = 0; run < nRepeats; run++) {
+			double run_ms = 0.0;
+			for (size_t i = 0; i < suite.n; i++) {
+				const BenchPosition& position = suite.positions[i];
+				std::string moves(position.moves);
+				Board b;
+				Board::FromMoves(moves, b);
+
+				bool bCount = counters && (run == 0);
+				if (bCount)
+					counters->Start();
+				auto c_start = std::chrono::steady_clock::now();
+				p->SolveBoard(b, (unsigned int)moves.size());
+				auto c_end = std::chrono::steady_clock::now();
+				if (bCount)
+					r.perf.Add(counters->Stop());
+				run_ms += std::chrono::duration<double, std::milli>(c_end - c_start).count();
+
+				unsigned long long nodes = p->GetLastSearchStats().nodes;
+				if (run == 0) {
+					r.positionNodes.push_back(nodes);
+					r.nodes += nodes;
+					if (p->GetLastScore() == position.score)
+						r.correct++;
+					else if (r.bVerified)
+						std::cout << suite.name << " " << moves << ": score " << p->GetLastScore() << ", expected " << position.score << std::endl;
+				}
+				else if (nodes != r.positionNodes[i]) {
+					std::cout << suite.name << " " << moves << ": " << nodes << " nodes, " << r.positionNodes[i] << " in the first run" << std::endl;
+					bCorrect = false;
+				}
+			}
+			r.runs_ms.push_back(run_ms);
+		}
+		r.total_ms = Median(r.runs_ms);
+		r.mad_ms = MedianAbsoluteDeviation(r.runs_ms);
+
+		if (r.bVerified && (r.correct != r.positions))
+			bCorrect = false;
+		results.push_back(r);
+	}
+	return bCorrect;
+}
+
+/// <summary>
+/// PrintBenchmarkResults() displays the results of RunBenchmarkSuites() as a table and writes them as JSON, e.g.:
+///   {"solver":"ab","depth":0,"suites":[{"name":"end-easy","depth":14,"positions":12,"correct":12,"verified":true,"mean_ms":0.3,
+///    "nodes":68000,"nodes_per_sec":2.6e+07}, ...]}
+/// With hardware counters, each suite also has e.g. "perf":{"cycles":1.2e+08,"instructions":3.1e+08,...} and a counter table is displayed.
+/// </summary>
+/// <param name="solver">Solver benchmarked</param>
+/// <param name="depth">Depth requested (0 = the depth of each suite)</param>
+/// <param name="results">Results of RunBenchmarkSuites()</param>
+/// <param name="json">Stream to which the JSON is written</param>
+void PrintBenchmarkResults(const std::string& solver, unsigned int depth, const std::vector<BenchSuiteResult>& results, std::ostream& json) {
+	std::cout << std::left << std::setw(16) << "Suite" << std::right << std::setw(7) << "Depth" << std::setw(11) << "Positions" << std::setw(9) << "Correct" 
+		<< std::setw(12) << "Mean ms" << std::setw(14) << "Nodes" << std::setw(14) << "Nodes/sec" << std::endl;
+	for (const BenchSuiteResult& r : results) {
+		double nps = (r.total_ms > 0) ? 1000.0 * r.nodes / r.total_ms : 0.0;
+		std::cout << std::left << std::setw(16) << r.name << std::right << std::setw(7) << r.depth << std::setw(11) << r.positions
+			<< std::setw(9) << (r.bVerified ? std::to_string(r.correct) : std::string("-")) << std::fixed << std::setprecision(3) << std::setw(12) 
+			<< r.total_ms / r.positions << std::setprecision(0) << std::setw(14) << (double)r.nodes << std::setw(14) << nps << std::endl;
+		std::cout.unsetf(std::ios::fixed);
+		std::cout << std::setprecision(6);
+	}
+
+	// Hardware counters per node and per move (each position is one move)
+	for (const BenchSuiteResult& r : results) {
+		if (r.perf.IsEmpty())
+			continue;
+		std::cout << std::endl << r.name << std::endl;
+		PerfCounters::PrintReport(std::cout, r.perf, (double)r.nodes, (double)r.positions);
+	}
+
+	json << "{\"solver\":\"" << solver << "\",\"depth\":" << depth << ",\"suites\":[";
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchSuiteResult& r = results[i];
+		double nps = (r.total_ms > 0) ? 1000.0 * r.nodes / r.total_ms : 0.0;
+		json << ((i == 0) ? "" : ",") << "{\"name\":\"" << r.name << "\",\"depth\":" << r.depth << ",\"positions\":" << r.positions
+			<< ",\"correct\":" << r.correct << ",\"verified\":" << (r.bVerified ? "true" : "false") << ",\"mean_ms\":" << r.total_ms / r.positions
+			<< ",\"nodes\":" << r.nodes << ",\"nodes_per_sec\":" << nps << ",\"runs\":" << r.runs_ms.size() << ",\"mad_ms\":" << r.mad_ms;
+		if (!r.perf.IsEmpty()) {
+			json << ",\"perf\":{";
+			bool bFirst = true;
+			for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+				if (!r.perf.bValid[e])
+					continue;
+				json << (bFirst ? "" : ",") << "\"" << PerfCounters::EventName((t_PmuEvent)e) << "\":" << r.perf.count[e];
+				bFirst = false;
+			}
+			json << "}";
+		}
+		json << "}";
+	}
+	json << "]}" << std::endl;
+}
+
+//
+// Baselines
+//
+
+/// <summary>
+/// JsonValue is a parsed JSON value; JsonReader parses the JSON written by the benchmarks (no escapes other than \" and \\ in strings)
+/// </summary>
+struct JsonValue {
+	enum t_Type { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT } type = JSON_NULL;
+	double number = 0.0;
+	std::string text;
+	std::vector<JsonValue> items;
+	std::vector<std::pair<std::string, JsonValue>> members;
+
+	const JsonValue* Find(const std::string& key) const {
+		for (const auto& m : members) {
+			if (m.first == key)
+				return &m.second;
+		}
+		return nullptr;
+	}
+	double Number(const std::string& key) const {
+		const JsonValue* v = Find(key);
+		return (v && (v->type == JSON_NUMBER)) ? v->number : 0.0;
+	}
+	std::string Text(const std::string& key) const {
+		const JsonValue* v = Find(key);
+		return (v && (v->type == JSON_STRING)) ? v->text : std::string();
+	}
+};
+
+class JsonReader
+{
+private:
+	const std::string& s;
+	size_t pos;
+
+	void SkipSpaces(void) {
+		while ((pos < s.size()) && isspace((unsigned char)s[pos]))
+			pos++;
+	}
+	bool Expect(char c) {
+		SkipSpaces();
+		if ((pos < s.size()) && (s[pos] == c)) {
+			pos++;
+			return true;
+		}
+		return false;
+	}
+	bool ParseString(std::string& out) {
+		if (!Expect('"'))
+			return false;
+		out.clear();
+		while (pos < s.size()) {
+			char c = s[pos++];
+			if (c == '"')
+				return true;
+			if ((c == '\\') && (pos < s.size()))
+				c = s[pos++];
+			out.push_back(c);
+		}
+		return false;
+	}
+
+public:
+	JsonReader(const std::string& text) : s(text), pos(0) {}
+
+	bool Parse(JsonValue& v) {
+		SkipSpaces();
+		if (pos >= s.size())
+			return false;
+		char c = s[pos];
+		if (c == '{') {
+			pos++;
+			v.type = JsonValue::JSON_OBJECT;
+			if (Expect('}'))
+				return true;
+			do {
+				std::pair<std::string, JsonValue> m;
+				if (!ParseString(m.first) || !Expect(':') || !Parse(m.second))
+					return false;
+				v.members.push_back(m);
+			} while (Expect(','));
+			return Expect('}');
+		}
+		if (c == '[') {
+			pos++;
+			v.type = JsonValue::JSON_ARRAY;
+			if (Expect(']'))
+				return true;
+			do {
+				v.items.emplace_back();
+				if (!Parse(v.items.back()))
+					return false;
+			} while (Expect(','));
+			return Expect(']');
+		}
+		if (c == '"') {
+			v.type = JsonValue::JSON_STRING;
+			return ParseString(v.text);
+		}
+		if (s.compare(pos, 4, "true") == 0 || s.compare(pos, 5, "false") == 0 || s.compare(pos, 4, "null") == 0) {
+			v.type = (c == 'n') ? JsonValue::JSON_NULL : JsonValue::JSON_BOOL;
+			v.number = (c == 't') ? 1.0 : 0.0;
+			pos += (c == 'f') ? 5 : 4;
+			return true;
+		}
+		const char* start = s.c_str() + pos;
+		char* end;
+		v.type = JsonValue::JSON_NUMBER;
+		v.number = strtod(start, &end);
+		if (end == start)
+			return false;
+		pos += end - start;
+		return true;
+	}
+};
+
+/// <summary>
+/// SaveBenchmarkBaseline() writes the results of RunBenchmarkSuites() to a baseline file, to be compared against by later runs, e.g.:
+///   {"solver":"ab","depth":0,"suites":[{"name":"end-easy","depth":14,"runs":5,"median_ms":3.2,"mad_ms":0.04,"nodes":71298,
+///    "nodes_per_sec":2.2e+07,"position_nodes":[1530,862,...]}, ...]}
+/// </summary>
+/// <param name="filename">Baseline file (overwritten)</param>
+/// <param name="solver">Solver benchmarked</param>
+/// <param name="depth">Depth requested (0 = the depth of each suite)</param>
+/// <param name="results">Results of RunBenchmarkSuites()</param>
+/// <returns>false if the file could not be written</returns>
+bool SaveBenchmarkBaseline(const std::string& filename, const std::string& solver, unsigned int depth, const std::vector<BenchSuiteResult>& results) {
+	std::ofstream out(filename);
+	if (!out) {
+		std::cout << "Cannot write baseline " << filename << std::endl;
+		return false;
+	}
+	out << std::setprecision(10);
+	out << "{\"solver\":\"" << solver << "\",\"depth\":" << depth << ",\"suites\":[";
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchSuiteResult& r = results[i];
+		out << ((i == 0) ? "" : ",") << "\n {\"name\":\"" << r.name << "\",\"depth\":" << r.depth << ",\"runs\":" << r.runs_ms.size() 
+			<< ",\"median_ms\":" << r.total_ms << ",\"mad_ms\":" << r.mad_ms << ",\"nodes\":" << r.nodes 
+			<< ",\"nodes_per_sec\":" << ((r.total_ms > 0) ? 1000.0 * r.nodes / r.total_ms : 0.0) << ",\"position_nodes\":[";
+		for (size_t k = 0; k < r.positionNodes.size(); k++) {
+			out << ((k == 0) ? "" : ",") << r.positionNodes[k];
+		}
+		out << "]}";
+	}
+	out << "\n]}" << std::endl;
+	std::cout << "Baseline saved to " << filename << std::endl;
+	return (bool)out;
+}
+
+/// <summary>
+/// CompareBenchmarkBaseline() compares the results of RunBenchmarkSuites() against a baseline file.
+///   Node counts are exact checks: a search that visits a different number of nodes at the same depth has changed, whatever its speed.
+///   Times are statistical checks: a suite is slower if its median time exceeds the baseline's by more than the larger of the relative threshold
+///   and the noise of the two measurements (3 standard deviations, estimated as 1.4826 x MAD).  Repeated runs (--repeat) tighten the noise.
+/// </summary>
+/// <param name="filename">Baseline file (see SaveBenchmarkBaseline())</param>
+/// <param name="solver">Solver benchmarked</param>
+/// <param name="depth">Depth requested (0 = the depth of each suite)</param>
+/// <param name="results">Results of RunBenchmarkSuites()</param>
+/// <param name="threshold">Slowdown tolerated regardless of the noise (0.05 = 5%)</param>
+/// <returns>BASELINE_MISMATCH if the baseline cannot be read or does not match (solver, depths, node counts); otherwise BASELINE_SLOWER if a suite is slower</returns>
+t_BaselineStatus CompareBenchmarkBaseline(const std::string& filename, const std::string& solver, unsigned int depth, const std::vector<BenchSuiteResult>& results, 
+	double threshold) {
+	std::ifstream in(filename);
+	std::stringstream text;
+	text << in.rdbuf();
+	std::string json = text.str();
+	JsonValue baseline;
+	JsonReader reader(json);
+	if (!in || !reader.Parse(baseline) || (baseline.type != JsonValue::JSON_OBJECT)) {
+		std::cout << "Cannot read baseline " << filename << std::endl;
+		return BASELINE_MISMATCH;
+	}
+	if ((baseline.Text("solver") != solver) || ((unsigned int)baseline.Number("depth") != depth)) {
+		std::cout << "Baseline " << filename << " is for solver " << baseline.Text("solver") << " at depth " << baseline.Number("depth") << std::endl;
+		return BASELINE_MISMATCH;
+	}
+	const JsonValue* suites = baseline.Find("suites");
+
+	t_BaselineStatus status = BASELINE_OK;
+	std::cout << "Compared with " << filename << " (threshold " << 100.0 * threshold << "%)" << std::endl;
+	std::cout << std::left << std::setw(16) << "Suite" << std::right << std::setw(12) << "Base ms" << std::setw(12) << "New ms" << std::setw(10) << "Change"
+		<< std::setw(12) << "Allowed" << std::setw(10) << "Nodes" << "  Status" << std::endl;
+	for (const BenchSuiteResult& r : results) {
+		const JsonValue* base = nullptr;
+		for (size_t i = 0; suites && (i < suites->items.size()); i++) {
+			if (suites->items[i].Text("name") == r.name)
+				base = &suites->items[i];
+		}
+		std::cout << std::left << std::setw(16) << r.name << std::right;
+		if (!base || ((unsigned int)base->Number("depth") != r.depth)) {
+			std::cout << "  not in baseline (at depth " << r.depth << ")" << std::endl;
+			status = BASELINE_MISMATCH;
+			continue;
+		}
+
+		// Node counts: exact
+		const JsonValue* baseNodes = base->Find("position_nodes");
+		size_t mismatch = r.positionNodes.size();
+		if (!baseNodes || (baseNodes->items.size() != r.positionNodes.size()))
+			mismatch = 0;
+		else {
+			for (size_t k = 0; k < r.positionNodes.size(); k++) {
+				if ((unsigned long long)baseNodes->items[k].number != r.positionNodes[k]) {
+					mismatch = k;
+					break;
+				}
+			}
+		}
+		bool bNodesMatch = (mismatch == r.positionNodes.size());
+
+		// Time: median against median, allowing for the noise of both
+		double base_ms = base->Number("median_ms");
+		double base_mad = base->Number("mad_ms");
+		double change = r.total_ms - base_ms;
+		double noise = 3.0 * 1.4826 * std::sqrt(base_mad * base_mad + r.mad_ms * r.mad_ms);
+		double allowed = std::max(threshold * base_ms, noise);
+
+		std::cout << std::fixed << std::setprecision(3) << std::setw(12) << base_ms << std::setw(12) << r.total_ms << std::setprecision(1) 
+			<< std::setw(9) << ((base_ms > 0) ? 100.0 * change / base_ms : 0.0) << "%" << std::setprecision(3) << std::setw(12) << allowed
+			<< std::setw(10) << (bNodesMatch ? "same" : "CHANGED");
+		std::cout.unsetf(std::ios::fixed);
+		std::cout << std::setprecision(6);
+
+		if (!bNodesMatch) {
+			std::cout << "  MISMATCH";
+			if (baseNodes && (baseNodes->items.size() == r.positionNodes.size()))
+				std::cout << " (position " << mismatch + 1 << ": " << r.positionNodes[mismatch] << " nodes, baseline " 
+					<< (unsigned long long)baseNodes->items[mismatch].number << ")";
+			status = BASELINE_MISMATCH;
+		}
+		else if (change > allowed) {
+			std::cout << "  SLOWER";
+			if (status == BASELINE_OK)
+				status = BASELINE_SLOWER;
+		}
+		else if (-change > allowed) {
+			std::cout << "  faster";
+		}
+		else {
+			std::cout << "  ok";
+		}
+		std::cout << std::endl;
+	}
+	return status;
+}
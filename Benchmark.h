@@ -0,0 +1,58 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <iostream>
+#include "Board.h"
+#include "PerfCounters.h"
+
+// Micro-benchmarks
+void BenchmarkIsWin(size_t n, unsigned int nRepeats = 10);
+
+// Perft (move generation)
+unsigned long long Perft(Board& b, typePlayer p, unsigned int depth);
+unsigned long long PerftParallel(const Board& b, typePlayer p, unsigned int depth, unsigned int nThreads = 0);
+bool BenchmarkPerft(const std::string& moves, unsigned int maxDepth, unsigned int nThreads = 1);
+
+/// <summary>
+/// BenchSuiteResult is the result of solving every position of a benchmark suite once
+/// </summary>
+struct BenchSuiteResult {
+	std::string name;
+	unsigned int depth = 0;
+	size_t positions = 0;
+	size_t correct = 0;			// positions whose score matched the expected score
+	bool bVerified = false;		// false if the suite was not searched at its own depth (the expected scores do not apply)
+	double total_ms = 0.0;		// time to solve every position of the suite (median over the runs)
+	double mad_ms = 0.0;		// median absolute deviation of the runs
+	std::vector<double> runs_ms;	// time of each run
+	unsigned long long nodes = 0;
+	std::vector<unsigned long long> positionNodes;	// nodes searched for each position
+	PerfSample perf;			// hardware counters over the searches (empty if not measured or not available)
+};
+
+// Position suites
+bool RunBenchmarkSuites(const std::string& solver, unsigned int depth, std::vector<BenchSuiteResult>& results, bool bPerfCounters = false,
+	unsigned int nRepeats = 1);
+void PrintBenchmarkResults(const std::string& solver, unsigned int depth, const std::vector<BenchSuiteResult>& results, std::ostream& json);
+
+// Baselines (regression checks)
+enum t_BaselineStatus { BASELINE_OK = 0, BASELINE_MISMATCH = 1, BASELINE_SLOWER = 2 };
+bool SaveBenchmarkBaseline(const std::string& filename, const std::string& solver, unsigned int depth, const std::vector<BenchSuiteResult>& results);
+t_BaselineStatus CompareBenchmarkBaseline(const std::string& filename, const std::string& solver, unsigned int depth, const std::vector<BenchSuiteResult>& results, 
+	double threshold = 0.05);
@@ -15,9 +15,12 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <iostream>
+#include <fstream>
 #include <bitset>
 #include <ctime>
+#include <cstring>
 #include "Board.h"
+#include "CpuFeatures.h"
 
 //
 // Constructors and Initializers
@@ -258,13 +261,289 @@ Move Board::FindKillerMove(typePlayer p) {
 	return (Move)0;
 }
 
+/// <summary>
+/// Board::PlayMoves() plays a sequence of moves, written as column numbers (e.g., "4453"), starting with the player to move.
+/// Used to set up a position, e.g., the start position of an opening.  The last move may win the game: the caller checks for a finished game
+/// if it needs a position to play on.
+/// </summary>
+/// <param name="moves">Sequence of moves ('1' thru '7')</param>
+/// <returns>true if all the moves were played; false if a move is not a column, is not valid, or is played after the game was won</returns>
+bool Board::PlayMoves(const std::string& moves) {
+	return PlayMoves(moves.data(), moves.size());
+}
+
+/// <summary>
+/// Board::PlayMoves() plays a sequence of moves held in a character buffer (not necessarily null-terminated)
+/// </summary>
+/// <param name="moves">Sequence of moves ('1' thru '7')</param>
+/// <param name="n">Number of moves</param>
+/// <returns>true if all the moves were played; false if a move is not a column, is not valid, or is played after the game was won</returns>
+bool Board::PlayMoves(const char* moves, size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		char c = moves[i];
+		if ((c < '1') || (c > ('0' + WIDTH)))
+			return false;
+
+		Move m = (Move)(c - '0');
+		if (!IsValidMove(m))
+			return false;
+
+		typePlayer p = GetPlayerToMove();
+		MakeMove(m, p);
+		if ((i + 1 < n) && IsWin(p))
+			return false;
+	}
+	return true;
+}
+
+//
+// Position notation
+//
+
+/// <summary>
+/// CountBits() returns the number of bits set in a bitboard
+/// </summary>
+static inline unsigned int CountBits(BitBoard b) {
+#if defined(__GNUC__)
+	return (unsigned int)__builtin_popcountll(b);
+#else
+	unsigned int n = 0;
+	for (; b; b &= b - 1)
+		n++;
+	return n;
+#endif
+}
+
+/// <summary>
+/// Board::NumberOfMoves() returns the number of moves played to reach this position (the number of pieces on the board), i.e., the MoveNumber 
+/// passed to the solvers
+/// </summary>
+/// <param name=""></param>
+/// <returns>Number of pieces on the board</returns>
+unsigned int Board::NumberOfMoves(void) {
+	return CountBits(b[RED] | b[YELLOW]);
+}
+
+/// <summary>
+/// Board::FromMoves() sets up the position reached by a sequence of moves from the empty board (RED moves first), e.g., Board::FromMoves("4453", b)
+/// </summary>
+/// <param name="moves">Sequence of moves ('1' thru '7')</param>
+/// <param name="b">Returns the position</param>
+/// <returns>false if a move is not a column or is not valid, or if the game is won before the last move (a win by the last move is accepted)</returns>
+bool Board::FromMoves(const std::string& moves, Board& b) {
+	return FromMoves(moves.data(), moves.size(), b);
+}
+
+bool Board::FromMoves(const char* moves, size_t n, Board& b) {
+	b.InitBoard(RED);
+	return b.PlayMoves(moves, n);
+}
+
+/// <summary>
+/// Board::FromBitBoards() sets up a position from the bitboards of both players.  The player to move follows from the number of pieces
+/// (RED moves first).
+/// </summary>
+/// <param name="red">RED's pieces</param>
+/// <param name="yellow">YELLOW's pieces</param>
+/// <param name="b">Returns the position</param>
+/// <returns>false if the pieces overlap, are outside the board or float above an empty square, if the counts of pieces cannot occur in a game, 
+/// if the player to move has already won, or if the last player to move has a four in a row that was not completed by one of its top pieces
+/// (the game was won before the last move), as with FromMoves().  A position that passes these checks may still be unreachable.</returns>
+bool Board::FromBitBoards(BitBoard red, BitBoard yellow, Board& b) {
+	BitBoard mask = red | yellow;
+	const BitBoard board = BOTTOM * ((ONE << HEIGHT) - 1);	// every square of the board
+	if ((red & yellow) || (mask & ~board) || ((mask + BOTTOM) & mask))
+		return false;
+
+	unsigned int nRed = CountBits(red), nYellow = CountBits(yellow);
+	if ((nRed != nYellow) && (nRed != nYellow + 1))
+		return false;
+	typePlayer p = (nRed == nYellow) ? RED : YELLOW;
+	if (IsWinBitBoard((p == RED) ? red : yellow))
+		return false;
+
+	unsigned int h[WIDTH];
+	for (int i = 0; i < WIDTH; i++) {
+		h[i] = CountBits((mask >> (i * WIDTH)) & ((ONE << HEIGHT) - 1));
+	}
+
+	// A win by the last player to move must have been made by its last move, i.e., removing one of its top pieces undoes it
+	BitBoard last = (p == RED) ? yellow : red;
+	if (IsWinBitBoard(last)) {
+		bool bLastMove = false;
+		for (int i = 0; !bLastMove && (i < WIDTH); i++) {
+			BitBoard top = (h[i] != 0) ? ONE << (i * WIDTH + h[i] - 1) : 0;
+			bLastMove = (last & top) && !IsWinBitBoard(last & ~top);
+		}
+		if (!bLastMove)
+			return false;
+	}
+	b.SetPosition(red, yellow, h);
+	return true;
+}
+
+/// <summary>
+/// Board::SetPosition() sets the pieces of both players, already checked to form a position; the player to move follows from the number of pieces
+/// </summary>
+/// <param name="red">RED's pieces</param>
+/// <param name="yellow">YELLOW's pieces</param>
+/// <param name="h">Number of pieces in each column (h[0] is column 1)</param>
+void Board::SetPosition(BitBoard red, BitBoard yellow, const unsigned int* h) {
+	unsigned int n = 0;
+	b[RED] = red;
+	b[YELLOW] = yellow;
+	for (int i = 1; i < (WIDTH + 1); i++) {
+		height[i] = (unsigned short)((i - 1) * WIDTH + h[i - 1]);
+		n += h[i - 1];
+	}
+	b_PlayerToMove = (n % 2 == 0) ? RED : YELLOW;
+}
+
+/// <summary>
+/// Board::UnplayMoves() finds a sequence of moves that reaches this position, by taking back pieces from the top of the columns:
+/// each piece taken back must belong to the player who moved last, and no earlier position may already have been won.
+/// The position is restored on return.
+/// </summary>
+/// <param name="moves">Returns the moves (moves[0 .. n-1])</param>
+/// <param name="n">Number of pieces on the board</param>
+/// <param name="failed">Positions from which no sequence was found (so that they are not searched again)</param>
+/// <returns>true if a sequence was found</returns>
+bool Board::UnplayMoves(char* moves, unsigned int n, std::unordered_set<uint64_t>& failed) {
+	if (n == 0)
+		return true;
+	if (failed.count(Pack()))
+		return false;
+
+	typePlayer last = (typePlayer)!b_PlayerToMove;
+	for (Move m = 1; m <= WIDTH; m++) {
+		if ((height[m] == (m - 1) * WIDTH) || !((b[last] >> (height[m] - 1)) & 1))
+			continue;
+		TakeBackMove(m, last);
+		bool bFound = !IsWin(RED) && !IsWin(YELLOW) && UnplayMoves(moves, n - 1, failed);
+		MakeMove(m, last);
+		if (bFound) {
+			moves[n - 1] = (char)('0' + m);
+			return true;
+		}
+	}
+	failed.insert(Pack());
+	return false;
+}
+
+/// <summary>
+/// Board::ToMoves() returns a sequence of moves from the empty board (RED moves first) that reaches this position.  A position usually 
+/// has many such sequences; the one returned is the first found, trying the columns from left to right when taking back the last move.
+/// </summary>
+/// <param name="moves">Returns the moves</param>
+/// <returns>false if no sequence reaches this position (e.g., both players have four in a row)</returns>
+bool Board::ToMoves(std::string& moves) {
+	unsigned int n = CountBits(b[RED]) + CountBits(b[YELLOW]);
+	char buffer[WIDTH * HEIGHT];
+	std::unordered_set<uint64_t> failed;
+	moves.clear();
+	if ((b_PlayerToMove != ((n % 2 == 0) ? RED : YELLOW)) || IsWin(b_PlayerToMove) || !UnplayMoves(buffer, n, failed))
+		return false;
+	moves.assign(buffer, n);
+	return true;
+}
+
+/// <summary>
+/// Board::ToPositionString() returns the position as a fixed-width string of WIDTH columns, separated by '/', from left to right; each column 
+/// lists its HEIGHT squares from the bottom up: 'x' for RED, 'o' for YELLOW, '.' for empty.  E.g., after "4453":
+///   ....../....../o...../xo..../x...../....../......
+/// The player to move follows from the number of pieces (RED moves first).
+/// </summary>
+/// <returns>Position string (always POSITION_STRING_LENGTH characters)</returns>
+std::string Board::ToPositionString(void) {
+	std::string s(POSITION_STRING_LENGTH, '/');
+	for (int i = 0; i < WIDTH; i++) {
+		for (int h = 0; h < HEIGHT; h++) {
+			BitBoard square = ONE << (i * WIDTH + h);
+			s[i * (HEIGHT + 1) + h] = (b[RED] & square) ? 'x' : (b[YELLOW] & square) ? 'o' : '.';
+		}
+	}
+	return s;
+}
+
+/// <summary>
+/// Board::FromPositionString() sets up a position from a string written by ToPositionString()
+/// </summary>
+/// <param name="s">Position string</param>
+/// <param name="n">Length of the string (must be POSITION_STRING_LENGTH)</param>
+/// <param name="b">Returns the position</param>
+/// <returns>false if the string is not a valid position (see FromBitBoards())</returns>
+bool Board::FromPositionString(const std::string& s, Board& b) {
+	return FromPositionString(s.data(), s.size(), b);
+}
+
+bool Board::FromPositionString(const char* s, size_t n, Board& b) {
+	if (n != POSITION_STRING_LENGTH)
+		return false;
+	BitBoard red = 0, yellow = 0;
+	for (int i = 0; i < WIDTH; i++) {
+		const char* column = s + i * (HEIGHT + 1);
+		if ((i < WIDTH - 1) && (column[HEIGHT] != '/'))
+			return false;
+		for (int h = 0; h < HEIGHT; h++) {
+			BitBoard square = ONE << (i * WIDTH + h);
+			switch (column[h]) {
+			case 'x':
+				red |= square;
+				break;
+			case 'o':
+				yellow |= square;
+				break;
+			case '.':
+				break;
+			default:
+				return false;
+			}
+		}
+	}
+	return FromBitBoards(red, yellow, b);
+}
+
+/// <summary>
+/// Board::Pack() encodes the position in 49 bits: for each column, RED's pieces plus a marker bit just above the top piece (i.e., RED's 
+/// bitboard + the mask of all pieces + BOTTOM).  Every position has its own code, and the player to move follows from the number of pieces.
+/// </summary>
+/// <returns>Packed position</returns>
+uint64_t Board::Pack(void) {
+	BitBoard mask = b[RED] | b[YELLOW];
+	return b[RED] + mask + BOTTOM;
+}
+
+/// <summary>
+/// Board::Unpack() sets up a position from its packed encoding (see Pack())
+/// </summary>
+/// <param name="code">Packed position</param>
+/// <param name="b">Returns the position</param>
+/// <returns>false if the code is not a valid position (see FromBitBoards())</returns>
+bool Board::Unpack(uint64_t code, Board& b) {
+	if (code >> (WIDTH * WIDTH))
+		return false;
+	BitBoard red = 0, mask = 0;
+	for (int i = 0; i < WIDTH; i++) {
+		BitBoard column = (code >> (i * WIDTH)) & ((ONE << WIDTH) - 1);
+		if (column == 0)
+			return false;
+		int h = HEIGHT;
+		while (!(column & (ONE << h)))
+			h--;
+		BitBoard below = ((ONE << h) - 1) << (i * WIDTH);
+		mask |= below;
+		red |= (column << (i * WIDTH)) & below;
+	}
+	return FromBitBoards(red, mask & ~red, b);
+}
+
 /// <summary>
 /// TransposeMove() is a helper function for the transposition boards (FUTURE WORK)
 /// </summary>
 /// <param name="m">Move to be transposed</param>
 /// <returns></returns>
 Move TransposeMove(Move m) {
-	Move t_m;
+	Move t_m = 0;	// not a valid move
 	switch (m) {
 	case 1:
 		t_m = 7;
@@ -451,6 +730,235 @@ void Board::PrintTransposeBoard(typePlayer p) {
 	//PrintPossibleMoves();
 }
 
+//
+// Batch Board-related functions
+//
+
+#ifdef C4_X86
+C4_TARGET_AVX2
+static size_t IsWinBatchAVX2(const BitBoard* boards, size_t n, uint8_t* out) {
+	const __m256i zero = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i b = _mm256_loadu_si256((const __m256i*)(boards + i));
+		__m256i w, m;
+		m = _mm256_and_si256(b, _mm256_srli_epi64(b, 1));
+		w = _mm256_and_si256(m, _mm256_srli_epi64(m, 2));
+		m = _mm256_and_si256(b, _mm256_srli_epi64(b, 7));
+		w = _mm256_or_si256(w, _mm256_and_si256(m, _mm256_srli_epi64(m, 14)));
+		m = _mm256_and_si256(b, _mm256_srli_epi64(b, 6));
+		w = _mm256_or_si256(w, _mm256_and_si256(m, _mm256_srli_epi64(m, 12)));
+		m = _mm256_and_si256(b, _mm256_srli_epi64(b, 8));
+		w = _mm256_or_si256(w, _mm256_and_si256(m, _mm256_srli_epi64(m, 16)));
+		unsigned int noWin = (unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(w, zero)));
+		for (int l = 0; l < 4; l++) {
+			out[i + l] = (uint8_t)(((noWin >> l) & 1) ^ 1);
+		}
+	}
+	return i;
+}
+
+// GCC's AVX-512 intrinsics start from an undefined vector, which -Wmaybe-uninitialized reports as used
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+C4_TARGET_AVX512
+static size_t IsWinBatchAVX512(const BitBoard* boards, size_t n, uint8_t* out) {
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i b = _mm512_loadu_si512(boards + i);
+		__m512i w, m;
+		m = _mm512_and_si512(b, _mm512_srli_epi64(b, 1));
+		w = _mm512_and_si512(m, _mm512_srli_epi64(m, 2));
+		m = _mm512_and_si512(b, _mm512_srli_epi64(b, 7));
+		w = _mm512_or_si512(w, _mm512_and_si512(m, _mm512_srli_epi64(m, 14)));
+		m = _mm512_and_si512(b, _mm512_srli_epi64(b, 6));
+		w = _mm512_or_si512(w, _mm512_and_si512(m, _mm512_srli_epi64(m, 12)));
+		m = _mm512_and_si512(b, _mm512_srli_epi64(b, 8));
+		w = _mm512_or_si512(w, _mm512_and_si512(m, _mm512_srli_epi64(m, 16)));
+		unsigned int win = (unsigned int)_mm512_test_epi64_mask(w, w);
+		for (int l = 0; l < 8; l++) {
+			out[i + l] = (uint8_t)((win >> l) & 1);
+		}
+	}
+	return i;
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+/// <summary>
+/// IsWinBatch() determines, for many bitboards at once, if each bitboard contains four in a row (the same test as Board::IsWin()).
+/// The four shift directions are evaluated for 4 (AVX2) or 8 (AVX-512) bitboards per instruction; the instruction set is selected at run time
+/// and any remaining bitboards are evaluated by the scalar code.
+/// </summary>
+/// <param name="boards">Bitboards of a single player each</param>
+/// <param name="n">Number of bitboards</param>
+/// <param name="out">Returns 1 if the bitboard is won, 0 if not; one byte per bitboard</param>
+/// <param name="level">Instruction set to use (SIMD_AUTO for runtime dispatch)</param>
+void IsWinBatch(const BitBoard* boards, size_t n, uint8_t* out, t_SimdLevel level) {
+	size_t i = 0;
+
+#ifdef C4_X86
+	switch (ResolveSimdLevel(level)) {
+	case SIMD_AVX512:
+		i = IsWinBatchAVX512(boards, n, out);
+		break;
+	case SIMD_AVX2:
+		i = IsWinBatchAVX2(boards, n, out);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	for (; i < n; i++) {
+		out[i] = IsWinBitBoard(boards[i]) ? 1 : 0;
+	}
+}
+
+//
+// Position files
+//
+
+/// <summary>
+/// ParsePositionLines() is the parser behind ParsePositions(): it hands each valid position to add(red, yellow, heights), where heights[i] is 
+/// the number of pieces in column i+1.  Moves are played directly on two bitboards, without going through a Board.  As with Board::FromMoves(),
+/// the last move may win the game but no move may follow a win; as a four in a row stays on the board once made, this is found by testing the 
+/// final bitboards only, the last mover's without its last piece.
+/// </summary>
+template <typename AddPosition>
+static size_t ParsePositionLines(const char* text, size_t length, size_t* nInvalid, bool bFinal, AddPosition add) {
+	const char* p = text;
+	const char* end = text + length;
+	for (; ; ) {
+		const char* eol = (const char*)memchr(p, '\n', end - p);
+		if (!eol) {
+			if (!bFinal || (p == end))
+				break;
+			eol = end;
+		}
+
+		// The position ends at the first space, tab or carriage return
+		const char* q = p;
+		while ((q < eol) && (*q != ' ') && (*q != '\t') && (*q != '\r'))
+			q++;
+		size_t n = q - p;
+
+		if ((n != 0) && (*p != '#')) {
+			BitBoard bb[2] = { 0, 0 };
+			unsigned int h[WIDTH] = { 0 };
+			bool bValid = (n <= WIDTH * HEIGHT);
+			if ((n == POSITION_STRING_LENGTH) && (p[HEIGHT] == '/')) {
+				Board b;
+				bValid = Board::FromPositionString(p, n, b);
+				bb[RED] = b.GetBoard(RED);
+				bb[YELLOW] = b.GetBoard(YELLOW);
+				for (int i = 0; i < WIDTH; i++) {
+					for (BitBoard column = ((bb[RED] | bb[YELLOW]) >> (i * WIDTH)) & ((ONE << HEIGHT) - 1); column; column >>= 1)
+						h[i]++;
+				}
+			}
+			else {
+				BitBoard lastPiece = 0;
+				for (size_t i = 0; bValid && (i < n); i++) {
+					unsigned int column = (unsigned int)(p[i] - '1');
+					if ((column >= WIDTH) || (h[column] == HEIGHT))
+						bValid = false;
+					else {
+						lastPiece = ONE << (column * WIDTH + h[column]++);
+						bb[i & 1] |= lastPiece;
+					}
+				}
+				bValid = bValid && !IsWinBitBoard(bb[n & 1]) && !IsWinBitBoard(bb[(n - 1) & 1] & ~lastPiece);
+			}
+			if (bValid)
+				add(bb[RED], bb[YELLOW], h);
+			else if (nInvalid)
+				(*nInvalid)++;
+		}
+
+		p = (eol < end) ? eol + 1 : end;
+	}
+	return p - text;
+}
+
+/// <summary>
+/// ParsePositions() parses a buffer of positions, one per line, into boards.  A line holds a position written either as moves from the empty board
+/// (e.g., "4453") or as a position string (see Board::ToPositionString()); anything after the position (following a space or a tab, e.g., a score)
+/// is ignored, as are blank lines and lines starting with '#' (so the empty board can only be written as a position string).
+/// </summary>
+/// <param name="text">Positions</param>
+/// <param name="length">Length of the text</param>
+/// <param name="boards">The positions are appended to boards</param>
+/// <param name="nInvalid">If not null, incremented for each line that is not a valid position</param>
+/// <param name="bFinal">The buffer ends the text: a last line without an end of line is parsed (otherwise it is left for the next buffer)</param>
+/// <returns>Number of bytes parsed: up to the end of the last line parsed</returns>
+size_t ParsePositions(const char* text, size_t length, std::vector<Board>& boards, size_t* nInvalid, bool bFinal) {
+	return ParsePositionLines(text, length, nInvalid, bFinal, [&](BitBoard red, BitBoard yellow, const unsigned int* h) {
+		boards.emplace_back();
+		boards.back().SetPosition(red, yellow, h);
+	});
+}
+
+/// <summary>
+/// ParsePositions() parses a buffer of positions into their packed encodings (see Board::Pack()), 8 bytes per position
+/// </summary>
+size_t ParsePositions(const char* text, size_t length, std::vector<uint64_t>& codes, size_t* nInvalid, bool bFinal) {
+	return ParsePositionLines(text, length, nInvalid, bFinal, [&](BitBoard red, BitBoard yellow, const unsigned int*) {
+		codes.push_back(red + (red | yellow) + BOTTOM);
+	});
+}
+
+/// <summary>
+/// LoadPositionFile() reads a file of positions in chunks and parses each chunk as it is read, so that only the positions are held in memory
+/// </summary>
+template <typename Positions>
+static bool LoadPositionFile(const std::string& filename, Positions& positions, size_t* nInvalid) {
+	std::ifstream in(filename, std::ios::binary);
+	if (!in) {
+		std::cout << "Cannot open position file " << filename << std::endl;
+		return false;
+	}
+
+	const size_t CHUNK = 1 << 20;
+	std::vector<char> buffer(CHUNK);
+	size_t kept = 0;	// bytes of an incomplete line carried over from the previous chunk
+	for (; ; ) {
+		if (kept == buffer.size())
+			buffer.resize(2 * buffer.size());	// a line longer than the buffer
+		in.read(buffer.data() + kept, buffer.size() - kept);
+		size_t n = kept + (size_t)in.gcount();
+		bool bFinal = !in;
+		size_t used = ParsePositions(buffer.data(), n, positions, nInvalid, bFinal);
+		kept = n - used;
+		memmove(buffer.data(), buffer.data() + used, kept);
+		if (bFinal)
+			break;
+	}
+	return true;
+}
+
+/// <summary>
+/// LoadPositions() reads a file of positions (see ParsePositions())
+/// </summary>
+/// <param name="filename">Position file</param>
+/// <param name="boards">The positions are appended to boards</param>
+/// <param name="nInvalid">If not null, incremented for each line that is not a valid position</param>
+/// <returns>false if the file cannot be read</returns>
+bool LoadPositions(const std::string& filename, std::vector<Board>& boards, size_t* nInvalid) {
+	return LoadPositionFile(filename, boards, nInvalid);
+}
+
+/// <summary>
+/// LoadPositions() reads a file of positions into their packed encodings (see Board::Pack())
+/// </summary>
+bool LoadPositions(const std::string& filename, std::vector<uint64_t>& codes, size_t* nInvalid) {
+	return LoadPositionFile(filename, codes, nInvalid);
+}
+
 // FUTURE WORK: NegaMax
 /*
 int Board::negamax(int depth, typePlayer playerToMove, int color, MoveHistory* mh) {
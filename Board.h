@@ -15,17 +15,24 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
-#include <list>
+#include <string>
 #include<vector>
+#include <unordered_set>
+#include <cstddef>
+#include <cstdint>
+#include "CpuFeatures.h"
+#include "FixedVector.h"
 
 #define HEIGHT 6
 #define WIDTH 7
 #define SIZE (HEIGHT * (WIDTH+1))
 #define ONE 1ULL
 #define TOP ((0b0000001000000100000010000001000000100000010000001ULL) << HEIGHT)
+#define BOTTOM (0b0000001000000100000010000001000000100000010000001ULL)
+#define POSITION_STRING_LENGTH (WIDTH * (HEIGHT + 1) - 1)	// see Board::ToPositionString()
 
 typedef unsigned int Move;	// A move is the column in which the piece is to be dropped (possible valid moves are defined in MoveSequence[])
-typedef std::list <Move> typeMoveList;
+typedef FixedVector <Move, WIDTH> typeMoveList;	// the valid moves of a position (no memory allocation)
 
 /* 
 
@@ -52,6 +59,11 @@ private:
 	typePlayer b_PlayerToMove; // playerToMove in this position
 	unsigned short int height[WIDTH + 1]; // height is an array of the first available position in the column i; for convenience, height[0] is not used; and height[1] thru height [7] is used.
 
+	bool UnplayMoves(char* moves, unsigned int n, std::unordered_set<uint64_t>& failed);
+	void SetPosition(BitBoard red, BitBoard yellow, const unsigned int* h);
+
+	friend size_t ParsePositions(const char* text, size_t length, std::vector<Board>& boards, size_t* nInvalid, bool bFinal);
+
 	/* Future Work: Transposition Board */ 
 	// BitBoard transpose_b[2];
 	//unsigned short int t_height[WIDTH + 1]; // transposition height
@@ -76,11 +88,25 @@ public:
 	bool IsNoMove(void);
 	bool IsValidMove(Move m);
 	unsigned int NumberOfPossibleMoves(void);
+	unsigned int NumberOfMoves(void);
 	void MakeMove(Move m);
 	void MakeMove(Move m, typePlayer p);
 	//void TakeBackMove(Move m);
 	void TakeBackMove(Move m, typePlayer p);
 	Move FindKillerMove(typePlayer p);
+	bool PlayMoves(const std::string& moves);
+	bool PlayMoves(const char* moves, size_t n);
+
+	// Position notation
+	static bool FromMoves(const std::string& moves, Board& b);
+	static bool FromMoves(const char* moves, size_t n, Board& b);
+	static bool FromBitBoards(BitBoard red, BitBoard yellow, Board& b);
+	static bool FromPositionString(const std::string& s, Board& b);
+	static bool FromPositionString(const char* s, size_t n, Board& b);
+	static bool Unpack(uint64_t code, Board& b);
+	bool ToMoves(std::string& moves);
+	std::string ToPositionString(void);
+	uint64_t Pack(void);
 
 	// Board-related functions
 	bool IsWin(typePlayer p);
@@ -108,3 +134,27 @@ public:
 	*/
 };
 
+/// <summary>
+/// IsWinBitBoard() is the same test as Board::IsWin(), applied directly to a single player's bitboard; each direction is checked with two shifts instead of three
+/// </summary>
+inline bool IsWinBitBoard(BitBoard b) {
+	BitBoard m;
+	m = b & (b >> 1);
+	if (m & (m >> 2)) return true;
+	m = b & (b >> 7);
+	if (m & (m >> 14)) return true;
+	m = b & (b >> 6);
+	if (m & (m >> 12)) return true;
+	m = b & (b >> 8);
+	if (m & (m >> 16)) return true;
+	return false;
+}
+
+// Batch Board-related functions
+void IsWinBatch(const BitBoard* boards, size_t n, uint8_t* out, t_SimdLevel level = SIMD_AUTO);
+
+// Position files (one position per line: moves or position string)
+size_t ParsePositions(const char* text, size_t length, std::vector<Board>& boards, size_t* nInvalid = nullptr, bool bFinal = true);
+size_t ParsePositions(const char* text, size_t length, std::vector<uint64_t>& codes, size_t* nInvalid = nullptr, bool bFinal = true);
+bool LoadPositions(const std::string& filename, std::vector<Board>& boards, size_t* nInvalid = nullptr);
+bool LoadPositions(const std::string& filename, std::vector<uint64_t>& codes, size_t* nInvalid = nullptr);
@@ -0,0 +1,88 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "CpuFeatures.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/// <summary>
+/// DetectSimdLevel() returns the widest instruction set supported by both the CPU and the operating system.  The result is computed once.
+/// </summary>
+/// <param name=""></param>
+/// <returns>SIMD_AVX512, SIMD_AVX2 or SIMD_SCALAR</returns>
+t_SimdLevel DetectSimdLevel(void) {
+	static const t_SimdLevel level = []() {
+#if defined(C4_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return SIMD_SCALAR;
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		if (!osxsave)
+			return SIMD_SCALAR;
+		unsigned long long xcr0 = _xgetbv(0);
+		__cpuidex(info, 7, 0);
+		bool avx2 = ((info[1] & (1 << 5)) != 0) && ((xcr0 & 0x6) == 0x6);
+		bool avx512 = ((info[1] & (1 << 16)) != 0) && ((xcr0 & 0xE6) == 0xE6);
+		if (avx512)
+			return SIMD_AVX512;
+		if (avx2)
+			return SIMD_AVX2;
+		return SIMD_SCALAR;
+#elif defined(C4_X86)
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f"))
+			return SIMD_AVX512;
+		if (__builtin_cpu_supports("avx2"))
+			return SIMD_AVX2;
+		return SIMD_SCALAR;
+#else
+		return SIMD_SCALAR;
+#endif
+	}();
+	return level;
+}
+
+/// <summary>
+/// ResolveSimdLevel() maps a requested instruction set to one that can actually run on this CPU (SIMD_AUTO selects the widest)
+/// </summary>
+/// <param name="requested">Requested instruction set</param>
+/// <returns>Instruction set to use</returns>
+t_SimdLevel ResolveSimdLevel(t_SimdLevel requested) {
+	t_SimdLevel available = DetectSimdLevel();
+	if ((requested == SIMD_AUTO) || (requested > available))
+		return available;
+	return requested;
+}
+
+/// <summary>
+/// SimdLevelName() returns a printable name of the instruction set
+/// </summary>
+const char* SimdLevelName(t_SimdLevel level) {
+	switch (level) {
+	case SIMD_AVX512:
+		return "AVX-512";
+	case SIMD_AVX2:
+		return "AVX2";
+	case SIMD_SCALAR:
+		return "Scalar";
+	default:
+		return "Auto";
+	}
+}
@@ -0,0 +1,44 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+/*
+
+Runtime CPU dispatch.  Vectorized kernels are compiled into every build and selected at run time, so one binary runs on any x64 CPU.
+Under MSVC, intrinsics may be used without any special compiler switch.  Under GCC / Clang, each vectorized function is marked with 
+C4_TARGET_AVX2 or C4_TARGET_AVX512 so that it (and only it) is compiled for that instruction set.
+
+*/
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define C4_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(C4_X86) && !defined(_MSC_VER)
+#define C4_TARGET_AVX2 __attribute__((target("avx2")))
+#define C4_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define C4_TARGET_AVX2
+#define C4_TARGET_AVX512
+#endif
+
+enum t_SimdLevel { SIMD_AUTO = -1, SIMD_SCALAR = 0, SIMD_AVX2 = 1, SIMD_AVX512 = 2 };
+
+t_SimdLevel DetectSimdLevel(void);
+t_SimdLevel ResolveSimdLevel(t_SimdLevel requested);
+const char* SimdLevelName(t_SimdLevel level);
@@ -0,0 +1,227 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cmath>
+#include "EloRating.h"
+
+/// <summary>
+/// EloRating() sets up a pool of players with no results
+/// </summary>
+/// <param name="nPlayers">Number of players</param>
+EloRating::EloRating(unsigned int nPlayers) {
+	e_nPlayers = nPlayers;
+	e_score.assign((size_t)nPlayers * nPlayers, 0.0);
+	e_games.assign((size_t)nPlayers * nPlayers, 0.0);
+}
+
+/// <summary>
+/// EloRating::AddResult() adds the result of a game between players i and j
+/// </summary>
+/// <param name="i">First player</param>
+/// <param name="j">Second player</param>
+/// <param name="result">1 = i won, 0 = draw, -1 = j won</param>
+void EloRating::AddResult(unsigned int i, unsigned int j, int result) {
+	if ((i >= e_nPlayers) || (j >= e_nPlayers) || (i == j))
+		return;
+
+	double s = (result > 0) ? 1.0 : ((result < 0) ? 0.0 : 0.5);
+	e_score[(size_t)i * e_nPlayers + j] += s;
+	e_score[(size_t)j * e_nPlayers + i] += 1.0 - s;
+	e_games[(size_t)i * e_nPlayers + j] += 1.0;
+	e_games[(size_t)j * e_nPlayers + i] += 1.0;
+}
+
+/// <summary>
+/// EloRating::Compute() returns the maximum likelihood ratings and their 95% error bars.
+/// The strengths gamma are found with the minorization-maximization iteration of Hunter (2004):
+///   gamma_i = W_i / sum_j (n_ij / (gamma_i + gamma_j))
+/// and rating_i = 400 log10(gamma_i).  The covariance of the ratings is the pseudo-inverse of the Fisher information (a Laplacian, since only
+/// rating differences are defined), computed as (L + 11'/n)^-1 - 11'/n.
+/// Players that have not played are given a rating of 0 and an error of 0.
+/// If the players fall into groups that have not played each other, the information matrix has a second zero eigenvalue: the ratings
+/// are still returned (but are only comparable within a group) and the error bars are left at 0.
+/// </summary>
+/// <param name="elo">Returns the rating of each player (mean 0)</param>
+/// <param name="error95">Returns the half-width of the 95% interval of each rating</param>
+/// <returns>false if the players are not connected by games (no error bars)</returns>
+bool EloRating::Compute(std::vector<double>& elo, std::vector<double>& error95) const {
+	const unsigned int n = e_nPlayers;
+	const double eloPerNat = 400.0 / std::log(10.0);
+	elo.assign(n, 0.0);
+	error95.assign(n, 0.0);
+	if (n < 2)
+		return true;
+
+	// Results with the prior: one virtual draw between every pair of players that met
+	std::vector<double> score(e_score), games(e_games);
+	for (size_t k = 0; k < (size_t)n * n; k++) {
+		if (games[k] > 0) {
+			score[k] += 0.5;
+			games[k] += 1.0;
+		}
+	}
+
+	std::vector<double> wins(n, 0.0);
+	std::vector<bool> played(n, false);
+	for (unsigned int i = 0; i < n; i++) {
+		for (unsigned int j = 0; j < n; j++) {
+			wins[i] += score[(size_t)i * n + j];
+			if (games[(size_t)i * n + j] > 0)
+				played[i] = true;
+		}
+	}
+
+	// Minorization-maximization
+	std::vector<double> gamma(n, 1.0), next(n, 1.0);
+	for (int iteration = 0; iteration < 10000; iteration++) {
+		double maxChange = 0.0;
+		for (unsigned int i = 0; i < n; i++) {
+			if (!played[i])
+				continue;
+			double denominator = 0.0;
+			for (unsigned int j = 0; j < n; j++) {
+				double g = games[(size_t)i * n + j];
+				if (g > 0)
+					denominator += g / (gamma[i] + gamma[j]);
+			}
+			next[i] = wins[i] / denominator;
+		}
+
+		// Normalize to a geometric mean of 1 (ratings with a mean of 0)
+		double logMean = 0.0;
+		unsigned int nPlayed = 0;
+		for (unsigned int i = 0; i < n; i++) {
+			if (played[i]) {
+				logMean += std::log(next[i]);
+				nPlayed++;
+			}
+		}
+		logMean /= nPlayed;
+		for (unsigned int i = 0; i < n; i++) {
+			if (!played[i])
+				continue;
+			next[i] = std::exp(std::log(next[i]) - logMean);
+			maxChange = std::fmax(maxChange, std::fabs(std::log(next[i] / gamma[i])));
+			gamma[i] = next[i];
+		}
+		if (maxChange < 1e-10)
+			break;
+	}
+	for (unsigned int i = 0; i < n; i++) {
+		if (played[i])
+			elo[i] = eloPerNat * std::log(gamma[i]);
+	}
+
+	// Fisher information of the log-strengths: L_ii = sum_j n_ij p_ij p_ji, L_ij = -n_ij p_ij p_ji
+	// The matrix is extended with an identity block for players that have not played, so that it stays invertible.
+	std::vector<double> a((size_t)n * 2 * n, 0.0);	// [L + 11'/n | I], reduced to [I | (L + 11'/n)^-1]
+	unsigned int nPlayed = 0;
+	for (unsigned int i = 0; i < n; i++)
+		nPlayed += played[i] ? 1 : 0;
+	for (unsigned int i = 0; i < n; i++) {
+		for (unsigned int j = 0; j < n; j++) {
+			double v = 0.0;
+			if (!played[i] || !played[j]) {
+				v = (i == j) ? 1.0 : 0.0;
+			}
+			else {
+				v = 1.0 / nPlayed;
+				if (i == j) {
+					for (unsigned int k = 0; k < n; k++) {
+						double g = games[(size_t)i * n + k];
+						if (g > 0) {
+							double p = gamma[i] / (gamma[i] + gamma[k]);
+							v += g * p * (1.0 - p);
+						}
+					}
+				}
+				else {
+					double g = games[(size_t)i * n + j];
+					if (g > 0) {
+						double p = gamma[i] / (gamma[i] + gamma[j]);
+						v -= g * p * (1.0 - p);
+					}
+				}
+			}
+			a[(size_t)i * 2 * n + j] = v;
+		}
+		a[(size_t)i * 2 * n + n + i] = 1.0;
+	}
+
+	// Gauss-Jordan elimination with partial pivoting.  A pivot that is tiny relative to the diagonal is a zero eigenvalue
+	// left over by round-off: the pool is split into groups that have not played each other.
+	double maxDiagonal = 0.0;
+	for (unsigned int i = 0; i < n; i++)
+		maxDiagonal = std::fmax(maxDiagonal, std::fabs(a[(size_t)i * 2 * n + i]));
+	for (unsigned int c = 0; c < n; c++) {
+		unsigned int pivot = c;
+		for (unsigned int r = c + 1; r < n; r++) {
+			if (std::fabs(a[(size_t)r * 2 * n + c]) > std::fabs(a[(size_t)pivot * 2 * n + c]))
+				pivot = r;
+		}
+		if (std::fabs(a[(size_t)pivot * 2 * n + c]) < 1e-12 * maxDiagonal)
+			return false;	// singular (players not connected by games): no error bars
+		if (pivot != c) {
+			for (unsigned int k = 0; k < 2 * n; k++)
+				std::swap(a[(size_t)c * 2 * n + k], a[(size_t)pivot * 2 * n + k]);
+		}
+		double d = a[(size_t)c * 2 * n + c];
+		for (unsigned int k = 0; k < 2 * n; k++)
+			a[(size_t)c * 2 * n + k] /= d;
+		for (unsigned int r = 0; r < n; r++) {
+			double f = a[(size_t)r * 2 * n + c];
+			if ((r == c) || (f == 0.0))
+				continue;
+			for (unsigned int k = 0; k < 2 * n; k++)
+				a[(size_t)r * 2 * n + k] -= f * a[(size_t)c * 2 * n + k];
+		}
+	}
+
+	for (unsigned int i = 0; i < n; i++) {
+		if (!played[i])
+			continue;
+		double variance = a[(size_t)i * 2 * n + n + i] - 1.0 / nPlayed;
+		error95[i] = 1.96 * eloPerNat * std::sqrt(std::fmax(variance, 0.0));
+	}
+	return true;
+}
+
+/// <summary>
+/// EloRating::NumberOfPlayers() returns the size of the pool
+/// </summary>
+unsigned int EloRating::NumberOfPlayers(void) const {
+	return e_nPlayers;
+}
+
+/// <summary>
+/// EloRating::GetScore() returns the points scored by player i (1 per win, 1/2 per draw), not including the prior
+/// </summary>
+double EloRating::GetScore(unsigned int i) const {
+	double s = 0.0;
+	for (unsigned int j = 0; j < e_nPlayers; j++)
+		s += e_score[(size_t)i * e_nPlayers + j];
+	return s;
+}
+
+/// <summary>
+/// EloRating::GetGames() returns the number of games played by player i
+/// </summary>
+double EloRating::GetGames(unsigned int i) const {
+	double g = 0.0;
+	for (unsigned int j = 0; j < e_nPlayers; j++)
+		g += e_games[(size_t)i * e_nPlayers + j];
+	return g;
+}
@@ -0,0 +1,42 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <vector>
+
+/// <summary>
+/// EloRating estimates the Elo ratings of a pool of players from their game results, by maximum likelihood under the Bradley-Terry 
+/// (logistic) model, with a draw counted as half a point for each player (there is no separate draw parameter).  Every pair of players 
+/// that met is given one virtual draw as a prior, so that a player with only wins (or only losses) still gets a finite rating.
+/// The ratings are relative (their mean is 0); the error bars are 95% intervals from the inverse of the Fisher information.
+/// </summary>
+class EloRating
+{
+private:
+	unsigned int e_nPlayers;
+	std::vector<double> e_score;	// e_score[i * n + j] = points scored by i against j
+	std::vector<double> e_games;	// e_games[i * n + j] = games between i and j
+
+public:
+	EloRating(unsigned int nPlayers = 0);
+
+	void AddResult(unsigned int i, unsigned int j, int result);	// 1 = i won, 0 = draw, -1 = j won
+	bool Compute(std::vector<double>& elo, std::vector<double>& error95) const;	// false if the players are not connected by games
+
+	unsigned int NumberOfPlayers(void) const;
+	double GetScore(unsigned int i) const;	// points scored by i, over all opponents
+	double GetGames(unsigned int i) const;	// games played by i
+};
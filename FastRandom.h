@@ -0,0 +1,82 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// FastRandom is a small, fast pseudo-random number generator (xoshiro256**).  Unlike rand(), each instance carries its own state,
+/// so it can be owned by a single thread or a single solver without any locking.
+/// Reference: https://prng.di.unimi.it/
+/// </summary>
+class FastRandom
+{
+private:
+	uint64_t s[4];
+
+	static inline uint64_t Rotl(uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+
+public:
+	FastRandom(uint64_t seed = 0x9E3779B97F4A7C15ULL) {
+		Seed(seed);
+	}
+
+	/// <summary>
+	/// SplitMix64() scrambles a 64-bit value; used to expand a single seed into the four words of state
+	/// </summary>
+	static inline uint64_t SplitMix64(uint64_t& x) {
+		uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	void Seed(uint64_t seed) {
+		for (int i = 0; i < 4; i++) {
+			s[i] = SplitMix64(seed);
+		}
+	}
+
+	inline uint64_t Next(void) {
+		const uint64_t result = Rotl(s[1] * 5, 7) * 9;
+		const uint64_t t = s[1] << 17;
+
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = Rotl(s[3], 45);
+
+		return result;
+	}
+
+	/// <summary>
+	/// NextBounded() returns a random number in [0, n) using a multiply-shift instead of a modulo
+	/// </summary>
+	inline unsigned int NextBounded(unsigned int n) {
+		return (unsigned int)(((Next() >> 32) * (uint64_t)n) >> 32);
+	}
+
+	/// <summary>
+	/// NextDouble() returns a random number in [0, 1)
+	/// </summary>
+	inline double NextDouble(void) {
+		return (double)(Next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+};
@@ -0,0 +1,72 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <cstddef>
+#include <assert.h>
+
+/// <summary>
+/// FixedVector is a vector with a fixed capacity N, stored in place (on the stack, or inside the object that holds it), so that it never
+/// allocates memory.  Used for move lists and move histories, whose size is bounded by the board (at most WIDTH moves from a position,
+/// WIDTH * HEIGHT moves in a game).  Adding an element to a full FixedVector is a programming error (asserted).
+/// </summary>
+template <typename T, size_t N>
+class FixedVector
+{
+private:
+	T items[N];
+	size_t n = 0;
+
+public:
+	typedef T* iterator;
+	typedef const T* const_iterator;
+
+	void push_back(const T& v) {
+		assert(n < N);
+		items[n++] = v;
+	}
+	void pop_back(void) {
+		assert(n > 0);
+		n--;
+	}
+	void clear(void) {
+		n = 0;
+	}
+	template <typename It>
+	void assign(It first, It last) {
+		n = 0;
+		for (; first != last; ++first) {
+			push_back(*first);
+		}
+	}
+
+	size_t size(void) const { return n; }
+	bool empty(void) const { return n == 0; }
+	bool full(void) const { return n == N; }
+	static constexpr size_t capacity(void) { return N; }
+
+	T& operator[](size_t i) { return items[i]; }
+	const T& operator[](size_t i) const { return items[i]; }
+	T& back(void) { return items[n - 1]; }
+	const T& back(void) const { return items[n - 1]; }
+	T* data(void) { return items; }
+	const T* data(void) const { return items; }
+
+	iterator begin(void) { return items; }
+	iterator end(void) { return items + n; }
+	const_iterator begin(void) const { return items; }
+	const_iterator end(void) const { return items + n; }
+};
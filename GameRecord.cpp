@@ -0,0 +1,408 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include "GameRecord.h"
+
+static const char gameRecordMagic[4] = { 'C', '4', 'G', 'R' };
+static const char gameIndexMagic[4] = { 'C', '4', 'G', 'I' };
+#define GAMERECORD_HEADER_BYTES 8
+#define GAMERECORD_TRAILER_BYTES 20
+#define GAMERECORD_BUFFER (1 << 16)
+
+static void PutLE(uint8_t* p, uint64_t v, int nBytes) {
+	for (int i = 0; i < nBytes; i++) {
+		p[i] = (uint8_t)(v >> (8 * i));
+	}
+}
+
+static uint64_t GetLE(const uint8_t* p, int nBytes) {
+	uint64_t v = 0;
+	for (int i = 0; i < nBytes; i++) {
+		v |= (uint64_t)p[i] << (8 * i);
+	}
+	return v;
+}
+
+//
+// Records
+//
+
+/// <summary>
+/// GameResultFromWinner() converts the winner of a game as returned by the solvers (1 = RED, -1 = YELLOW, 0 = draw) to a game result
+/// </summary>
+t_GameResult GameResultFromWinner(int winner) {
+	return (winner == 1) ? GAME_RED_WINS : (winner == -1) ? GAME_YELLOW_WINS : GAME_DRAW;
+}
+
+/// <summary>
+/// WinnerFromGameResult() converts a game result to the winner (1 = RED, -1 = YELLOW, 0 = draw or unfinished)
+/// </summary>
+int WinnerFromGameResult(t_GameResult result) {
+	return (result == GAME_RED_WINS) ? 1 : (result == GAME_YELLOW_WINS) ? -1 : 0;
+}
+
+/// <summary>
+/// GameRecordSize() returns the size of a game record (header byte included) from its header byte
+/// </summary>
+size_t GameRecordSize(uint8_t header) {
+	return 1 + (3 * (size_t)(header & 0x3F) + 7) / 8;
+}
+
+/// <summary>
+/// EncodeGame() packs a game into a record: a header byte (number of moves, result) followed by the moves, 3 bits each
+/// </summary>
+/// <param name="moves">Moves (columns 1..7)</param>
+/// <param name="nMoves">Number of moves (at most WIDTH * HEIGHT)</param>
+/// <param name="result">Result of the game</param>
+/// <param name="out">Record (at least GAMERECORD_MAX_BYTES)</param>
+/// <returns>Size of the record, or 0 if the game is not valid</returns>
+size_t EncodeGame(const Move* moves, unsigned int nMoves, t_GameResult result, uint8_t* out) {
+	if (nMoves > WIDTH * HEIGHT)
+		return 0;
+	out[0] = (uint8_t)(nMoves | ((unsigned int)result << 6));
+	size_t size = GameRecordSize(out[0]);
+	memset(out + 1, 0, size - 1);
+
+	unsigned int bit = 0;
+	for (unsigned int i = 0; i < nMoves; i++, bit += 3) {
+		if ((moves[i] < 1) || (moves[i] > WIDTH))
+			return 0;
+		unsigned int v = (moves[i] - 1) << (bit & 7);	// at most 10 bits: spills over into the next byte at most
+		out[1 + (bit >> 3)] |= (uint8_t)v;
+		if (v > 0xFF)
+			out[2 + (bit >> 3)] |= (uint8_t)(v >> 8);
+	}
+	return size;
+}
+
+/// <summary>
+/// DecodeGame() unpacks a record written by EncodeGame()
+/// </summary>
+/// <param name="in">Record</param>
+/// <param name="available">Number of bytes available at in</param>
+/// <param name="moves">Returns the moves (room for WIDTH * HEIGHT)</param>
+/// <param name="nMoves">Returns the number of moves</param>
+/// <param name="result">Returns the result of the game</param>
+/// <returns>Size of the record, or 0 if it is incomplete or not valid (a column out of range or overfilled)</returns>
+size_t DecodeGame(const uint8_t* in, size_t available, Move* moves, unsigned int& nMoves, t_GameResult& result) {
+	if (available < 1)
+		return 0;
+	size_t size = GameRecordSize(in[0]);
+	nMoves = in[0] & 0x3F;
+	result = (t_GameResult)(in[0] >> 6);
+	if ((size > available) || (nMoves > WIDTH * HEIGHT))
+		return 0;
+
+	unsigned int filled[WIDTH] = { 0 };
+	unsigned int bit = 0;
+	for (unsigned int i = 0; i < nMoves; i++, bit += 3) {
+		unsigned int v = in[1 + (bit >> 3)];
+		if ((bit & 7) > 5)
+			v |= (unsigned int)in[2 + (bit >> 3)] << 8;
+		v = (v >> (bit & 7)) & 7;
+		if ((v >= WIDTH) || (++filled[v] > HEIGHT))
+			return 0;
+		moves[i] = v + 1;
+	}
+	return size;
+}
+
+//
+// Writer
+//
+
+GameRecordWriter::GameRecordWriter(void) {
+	w_used = 0;
+	w_offset = 0;
+	w_games = 0;
+	w_gamesPerBlock = 0;
+}
+
+GameRecordWriter::~GameRecordWriter(void) {
+	Close();
+}
+
+/// <summary>
+/// GameRecordWriter::Open() creates a game record file (overwriting it) and writes its header
+/// </summary>
+/// <param name="filename">Game record file</param>
+/// <param name="bIndex">Write a block index when the file is closed, so that the reader can seek to any game</param>
+/// <param name="gamesPerBlock">Number of games per block of the index (1..65535)</param>
+/// <returns>false if the file cannot be created</returns>
+bool GameRecordWriter::Open(const std::string& filename, bool bIndex, unsigned int gamesPerBlock) {
+	Close();
+	w_out.open(filename, std::ios::binary | std::ios::trunc);
+	if (!w_out) {
+		std::cout << "Cannot create game record file " << filename << std::endl;
+		return false;
+	}
+	if ((gamesPerBlock == 0) || (gamesPerBlock > 0xFFFF))
+		gamesPerBlock = GAMERECORD_BLOCK;
+	w_gamesPerBlock = bIndex ? gamesPerBlock : 0;
+	w_games = 0;
+	w_index.clear();
+	w_buffer.resize(GAMERECORD_BUFFER);
+
+	memcpy(w_buffer.data(), gameRecordMagic, 4);
+	w_buffer[4] = GAMERECORD_VERSION;
+	w_buffer[5] = bIndex ? 1 : 0;
+	PutLE(w_buffer.data() + 6, w_gamesPerBlock, 2);
+	w_used = GAMERECORD_HEADER_BYTES;
+	w_offset = 0;
+	return true;
+}
+
+/// <summary>
+/// GameRecordWriter::Flush() writes the buffer to the file
+/// </summary>
+bool GameRecordWriter::Flush(void) {
+	w_out.write((const char*)w_buffer.data(), w_used);
+	w_offset += w_used;
+	w_used = 0;
+	return (bool)w_out;
+}
+
+/// <summary>
+/// GameRecordWriter::WriteRecord() appends an encoded game
+/// </summary>
+bool GameRecordWriter::WriteRecord(const uint8_t* record, size_t size) {
+	if (!w_out.is_open())
+		return false;
+	if ((w_used + size > w_buffer.size()) && !Flush())
+		return false;
+	if (w_gamesPerBlock && (w_games % w_gamesPerBlock == 0))
+		w_index.push_back(w_offset + w_used);
+	memcpy(w_buffer.data() + w_used, record, size);
+	w_used += size;
+	w_games++;
+	return true;
+}
+
+/// <summary>
+/// GameRecordWriter::Write() appends a game
+/// </summary>
+/// <param name="moves">Moves (columns 1..7)</param>
+/// <param name="nMoves">Number of moves</param>
+/// <param name="result">Result of the game</param>
+/// <returns>false if the game is not valid or cannot be written</returns>
+bool GameRecordWriter::Write(const Move* moves, unsigned int nMoves, t_GameResult result) {
+	uint8_t record[GAMERECORD_MAX_BYTES];
+	size_t size = EncodeGame(moves, nMoves, result, record);
+	return (size != 0) && WriteRecord(record, size);
+}
+
+/// <summary>
+/// GameRecordWriter::Write() appends the game of a move history
+/// </summary>
+bool GameRecordWriter::Write(const MoveHistory& mh, t_GameResult result) {
+	uint8_t record[GAMERECORD_MAX_BYTES];
+	size_t size = mh.Serialize(record, result);
+	return (size != 0) && WriteRecord(record, size);
+}
+
+/// <summary>
+/// GameRecordWriter::Close() writes the buffered games and the index (if any) and closes the file
+/// </summary>
+/// <returns>false if the file could not be written</returns>
+bool GameRecordWriter::Close(void) {
+	if (!w_out.is_open())
+		return true;
+	bool bOK = Flush();
+	if (w_gamesPerBlock) {
+		uint64_t indexOffset = w_offset;
+		for (uint64_t offset : w_index) {
+			uint8_t entry[8];
+			PutLE(entry, offset, 8);
+			w_out.write((const char*)entry, 8);
+		}
+		uint8_t trailer[GAMERECORD_TRAILER_BYTES];
+		PutLE(trailer, indexOffset, 8);
+		PutLE(trailer + 8, w_games, 8);
+		memcpy(trailer + 16, gameIndexMagic, 4);
+		w_out.write((const char*)trailer, GAMERECORD_TRAILER_BYTES);
+		bOK = bOK && (bool)w_out;
+	}
+	w_out.close();
+	return bOK;
+}
+
+/// <summary>
+/// GameRecordWriter::NumberOfGames() returns the number of games written since the file was opened
+/// </summary>
+uint64_t GameRecordWriter::NumberOfGames(void) const {
+	return w_games;
+}
+
+//
+// Reader
+//
+
+GameRecordReader::GameRecordReader(void) {
+	r_pos = r_end = 0;
+	r_fileOffset = r_recordsEnd = 0;
+	r_games = r_next = 0;
+	r_gamesPerBlock = 0;
+}
+
+/// <summary>
+/// GameRecordReader::Open() opens a game record file and reads its index, if it has one
+/// </summary>
+/// <param name="filename">Game record file</param>
+/// <returns>false if the file cannot be read or is not a game record file</returns>
+bool GameRecordReader::Open(const std::string& filename) {
+	r_in.close();
+	r_in.clear();
+	r_in.open(filename, std::ios::binary);
+	uint8_t header[GAMERECORD_HEADER_BYTES];
+	if (!r_in || !r_in.read((char*)header, GAMERECORD_HEADER_BYTES) || (memcmp(header, gameRecordMagic, 4) != 0) || (header[4] != GAMERECORD_VERSION)) {
+		std::cout << "Not a game record file: " << filename << std::endl;
+		r_in.close();
+		return false;
+	}
+	r_in.seekg(0, std::ios::end);
+	uint64_t fileSize = (uint64_t)r_in.tellg();
+	r_recordsEnd = fileSize;
+	r_gamesPerBlock = 0;
+	r_games = 0;
+	r_index.clear();
+
+	// Index (only if the writer closed the file)
+	if ((header[5] & 1) && (fileSize >= GAMERECORD_HEADER_BYTES + GAMERECORD_TRAILER_BYTES)) {
+		uint8_t trailer[GAMERECORD_TRAILER_BYTES];
+		r_in.seekg(fileSize - GAMERECORD_TRAILER_BYTES);
+		r_in.read((char*)trailer, GAMERECORD_TRAILER_BYTES);
+		uint64_t indexOffset = GetLE(trailer, 8);
+		uint64_t games = GetLE(trailer + 8, 8);
+		unsigned int gamesPerBlock = (unsigned int)GetLE(header + 6, 2);
+		uint64_t nBlocks = (gamesPerBlock == 0) ? 0 : (games + gamesPerBlock - 1) / gamesPerBlock;
+		if (r_in && (memcmp(trailer + 16, gameIndexMagic, 4) == 0) && (gamesPerBlock != 0) && 
+			(indexOffset + 8 * nBlocks + GAMERECORD_TRAILER_BYTES == fileSize)) {
+			std::vector<uint8_t> index(8 * nBlocks);
+			r_in.seekg(indexOffset);
+			if (r_in.read((char*)index.data(), index.size())) {
+				for (uint64_t i = 0; i < nBlocks; i++) {
+					r_index.push_back(GetLE(index.data() + 8 * i, 8));
+				}
+				r_recordsEnd = indexOffset;
+				r_games = games;
+				r_gamesPerBlock = gamesPerBlock;
+			}
+		}
+		r_in.clear();
+	}
+
+	r_buffer.resize(GAMERECORD_BUFFER);
+	r_pos = r_end = 0;
+	r_next = 0;
+	r_fileOffset = GAMERECORD_HEADER_BYTES;
+	r_in.seekg(r_fileOffset);
+	return true;
+}
+
+/// <summary>
+/// GameRecordReader::Fill() moves the unread bytes to the front of the buffer and reads more of the games
+/// </summary>
+/// <returns>false if there is nothing more to read</returns>
+bool GameRecordReader::Fill(void) {
+	size_t left = r_end - r_pos;
+	memmove(r_buffer.data(), r_buffer.data() + r_pos, left);
+	r_pos = 0;
+	r_end = left;
+
+	uint64_t toRead = std::min<uint64_t>(r_buffer.size() - left, r_recordsEnd - r_fileOffset);
+	if (toRead == 0)
+		return false;
+	r_in.read((char*)r_buffer.data() + left, (std::streamsize)toRead);
+	size_t n = (size_t)r_in.gcount();
+	r_end += n;
+	r_fileOffset += n;
+	return n > 0;
+}
+
+/// <summary>
+/// GameRecordReader::Next() reads the next game
+/// </summary>
+/// <param name="moves">Returns the moves (room for WIDTH * HEIGHT)</param>
+/// <param name="nMoves">Returns the number of moves</param>
+/// <param name="result">Returns the result of the game</param>
+/// <returns>false at the end of the file (or at a record that is not valid)</returns>
+bool GameRecordReader::Next(Move* moves, unsigned int& nMoves, t_GameResult& result) {
+	if (r_end - r_pos < GAMERECORD_MAX_BYTES)
+		Fill();
+	size_t size = DecodeGame(r_buffer.data() + r_pos, r_end - r_pos, moves, nMoves, result);
+	if (size == 0)
+		return false;
+	r_pos += size;
+	r_next++;
+	return true;
+}
+
+/// <summary>
+/// GameRecordReader::Next() reads the next game into a move history
+/// </summary>
+bool GameRecordReader::Next(MoveHistory& mh, t_GameResult& result) {
+	if (r_end - r_pos < GAMERECORD_MAX_BYTES)
+		Fill();
+	size_t size = mh.Deserialize(r_buffer.data() + r_pos, r_end - r_pos, result);
+	if (size == 0)
+		return false;
+	r_pos += size;
+	r_next++;
+	return true;
+}
+
+/// <summary>
+/// GameRecordReader::Seek() positions the reader on a game: it jumps to the block of the game through the index, then reads past the games 
+/// before it in the block
+/// </summary>
+/// <param name="game">Number of the game (0 = first game)</param>
+/// <returns>false if the file has no index or has fewer games</returns>
+bool GameRecordReader::Seek(uint64_t game) {
+	if (!HasIndex() || (game >= r_games))
+		return false;
+	uint64_t block = game / r_gamesPerBlock;
+	r_in.clear();
+	r_fileOffset = r_index[block];
+	r_in.seekg(r_fileOffset);
+	r_pos = r_end = 0;
+	r_next = block * r_gamesPerBlock;
+
+	Move moves[WIDTH * HEIGHT];
+	unsigned int nMoves;
+	t_GameResult result;
+	while (r_next < game) {
+		if (!Next(moves, nMoves, result))
+			return false;
+	}
+	return true;
+}
+
+/// <summary>
+/// GameRecordReader::HasIndex() returns true if the file has an index (so that Seek() can be used)
+/// </summary>
+bool GameRecordReader::HasIndex(void) const {
+	return r_gamesPerBlock != 0;
+}
+
+/// <summary>
+/// GameRecordReader::NumberOfGames() returns the number of games in the file (0 if it has no index: the games can only be counted by reading them)
+/// </summary>
+uint64_t GameRecordReader::NumberOfGames(void) const {
+	return r_games;
+}
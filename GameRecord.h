@@ -0,0 +1,116 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "Board.h"
+#include "MoveHistory.h"
+
+/*
+
+Compact binary game records.  Each game is written as one header byte followed by the moves, packed 3 bits per move (column 1..7 stored as 0..6):
+
+  header:  bits 0-5 = number of moves (0..42), bits 6-7 = result (t_GameResult)
+  moves:   ceil(3 * number of moves / 8) bytes, least significant bit first
+
+A game of up to 40 moves takes at most 16 bytes; a full game of 42 moves takes 1 + 16 (126 bits) = 17 bytes.  Compared with a MoveHistory
+(4 bytes per move, plus the vector), a typical self-play game is about 10 times smaller.
+
+A game record file is:
+
+  file header (8 bytes):  "C4GR", version (1), flags (bit 0 = indexed), games per block (16 bits)
+  games:                  one record after another
+  index (if indexed):     file offset of the first game of each block (64 bits each)
+  trailer (if indexed):   offset of the index (64 bits), number of games (64 bits), "C4GI"
+
+Numbers are little-endian.  A file whose writer did not close it has no trailer; it can still be read from start to end, but not sought.
+
+*/
+
+#define GAMERECORD_MAX_BYTES 17
+#define GAMERECORD_VERSION 1
+#define GAMERECORD_BLOCK 4096
+
+enum t_GameResult : int { GAME_UNFINISHED = 0, GAME_RED_WINS = 1, GAME_YELLOW_WINS = 2, GAME_DRAW = 3 };
+
+t_GameResult GameResultFromWinner(int winner);
+int WinnerFromGameResult(t_GameResult result);
+
+size_t EncodeGame(const Move* moves, unsigned int nMoves, t_GameResult result, uint8_t* out);
+size_t DecodeGame(const uint8_t* in, size_t available, Move* moves, unsigned int& nMoves, t_GameResult& result);
+size_t GameRecordSize(uint8_t header);
+
+/// <summary>
+/// GameRecordWriter streams games to a game record file through a buffer; with an index, any game can later be found without reading the
+/// games before its block
+/// </summary>
+class GameRecordWriter
+{
+private:
+	std::ofstream w_out;
+	std::vector<uint8_t> w_buffer;
+	size_t w_used;
+	uint64_t w_offset;			// file offset of the start of the buffer
+	uint64_t w_games;
+	unsigned int w_gamesPerBlock;	// 0 = no index
+	std::vector<uint64_t> w_index;
+
+	bool Flush(void);
+	bool WriteRecord(const uint8_t* record, size_t size);
+
+public:
+	GameRecordWriter(void);
+	~GameRecordWriter(void);
+
+	bool Open(const std::string& filename, bool bIndex = true, unsigned int gamesPerBlock = GAMERECORD_BLOCK);
+	bool Write(const Move* moves, unsigned int nMoves, t_GameResult result);
+	bool Write(const MoveHistory& mh, t_GameResult result);
+	bool Close(void);
+	uint64_t NumberOfGames(void) const;
+};
+
+/// <summary>
+/// GameRecordReader reads the games of a game record file in order through a buffer, or from any game if the file is indexed
+/// </summary>
+class GameRecordReader
+{
+private:
+	std::ifstream r_in;
+	std::vector<uint8_t> r_buffer;
+	size_t r_pos;				// next byte of the buffer
+	size_t r_end;				// end of the data in the buffer
+	uint64_t r_fileOffset;		// file offset of the end of the data in the buffer
+	uint64_t r_recordsEnd;		// file offset of the end of the games
+	uint64_t r_games;			// number of games (indexed files only)
+	uint64_t r_next;			// number of the next game
+	unsigned int r_gamesPerBlock;
+	std::vector<uint64_t> r_index;
+
+	bool Fill(void);
+
+public:
+	GameRecordReader(void);
+
+	bool Open(const std::string& filename);
+	bool Next(Move* moves, unsigned int& nMoves, t_GameResult& result);
+	bool Next(MoveHistory& mh, t_GameResult& result);
+	bool Seek(uint64_t game);
+	bool HasIndex(void) const;
+	uint64_t NumberOfGames(void) const;
+};
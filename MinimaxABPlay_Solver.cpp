@@ -19,6 +19,7 @@
 #include <assert.h>
 #include "Solver_ConnectFour.h"
 #include "MinimaxABPlay_Solver.h"
+#include "PerfCounters.h"
 
 #define MAX_BESTVAL (WIDTH * (HEIGHT + 1))
 // #define MIN_SCORE (-(WIDTH * HEIGHT) / 2 + 3)
@@ -26,6 +27,8 @@
 #define WIN 10000
 #define LOSS -10000
 #define MAX_DEPTH 8
+#define DEADLINE_POLL_NODES 1024    // with a deadline, the clock (and the cancellation token) is checked every DEADLINE_POLL_NODES nodes
+#define TIME_BRANCHING_FACTOR 4.0   // assumed growth of the search time from one depth to the next (iterative deepening)
 
 //
 // Constructor and Initializers
@@ -41,7 +44,6 @@ MinimaxABPlay_Solver::MinimaxABPlay_Solver(int md, bool bVariety) : Solver_Conne
     s_max_depth = md;
     bVarietyOfPlay = bVariety;
     iTotalNumberOfMoves = 0;
-    numberOfNodes = 0;
     bShowMoveByMove = true;
     bShowWinner = true;
     SetPlayerName("Minimax Alpha-Beta Connect Four Player");
@@ -62,7 +64,10 @@ MinimaxABPlay_Solver::MinimaxABPlay_Solver(int md, bool bVariety) : Solver_Conne
 /// <param name="mh">Move History (needed for current number of moves)</param>
 /// <returns>Best Move</returns>
 Move MinimaxABPlay_Solver::GetBestMove(typePlayer playerToMove, unsigned int max_depth, bool isMaximizingPlayer, MoveHistory* mh) {
-    return GetBestMoveMinimaxAB(playerToMove, max_depth, isMaximizingPlayer, mh->NumberOfMoves());
+    BeginSearch(mh->NumberOfMoves());
+    Move m = GetBestMoveMinimaxAB(playerToMove, max_depth, isMaximizingPlayer, mh->NumberOfMoves());
+    EndSearch();
+    return m;
 }
 
 /// <summary>
@@ -105,18 +110,22 @@ Move MinimaxABPlay_Solver::GetBestMoveMinimaxAB(typePlayer playerToMove, unsigne
         for (auto const& v : s_board.MoveSequence) {
             if (s_board.IsValidMove(v)) {
                 // If the possible move is valid, 
-                numberOfNodes++;    // capture statistics of number of Nodes visited
+                s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);    // capture statistics of number of Nodes visited
                 
                 // ... Make the Move ...
                 s_board.MakeMove(v, p);
 
                 // ... Find the opponent's response, returning the appropriate valuation ...
 
+                if (C4_TRACE && bTrace)
+                    SearchTrace::Begin(TRACE_ROOT_MOVE, v);
                 double moveVal = AlphaBeta(max_depth, alpha, beta, (typePlayer)(!playerToMove), !isMaximizingPlayer, MoveNumber + 1);
+                if (C4_TRACE && bTrace)
+                    SearchTrace::End(TRACE_ROOT_MOVE, v);
 
                 // ... add some noise to the moveVal if it is equal to bestVal ...
                 if ((moveVal == bestVal) && (bVarietyOfPlay)) {
-                    moveVal += (-1 + 2 * ((float)rand()) / (float)RAND_MAX);
+                    moveVal += (-1 + 2 * s_rng.NextDouble());
                 }
 
                 // ... keep the best move ...
@@ -138,7 +147,8 @@ Move MinimaxABPlay_Solver::GetBestMoveMinimaxAB(typePlayer playerToMove, unsigne
 
         }
     }
-    // Return the bestMove
+    // Keep the score of the bestMove and return the bestMove
+    s_lastScore = (int)bestVal;
     return bestMove;
 }
 
@@ -160,6 +170,17 @@ int MinimaxABPlay_Solver::AlphaBeta(int depth, int alpha, int beta, typePlayer p
 
     color = isMaximizingPlayer ? 1 : -1;
 
+    // Timed search: give up once the deadline has passed or the search is cancelled (the caller discards the result)
+    if (bCheckDeadline && ((++pollNodes % DEADLINE_POLL_NODES) == 0) && 
+        ((pToken && pToken->IsCancelled()) || (std::chrono::steady_clock::now() >= deadline)))
+        bStopped = true;
+    if (bStopped)
+        return DRAW;
+
+    // Tracing: record one node in traceSampleEvery
+    if (C4_TRACE && bTraceNodes && ((++traceNodes % traceSampleEvery) == 0))
+        SearchTrace::Instant(TRACE_NODE, (int)(MoveNumber - s_rootMoveNumber));
+
     /*
     if (isMaximizingPlayer) {
         //p = RED;
@@ -173,17 +194,19 @@ int MinimaxABPlay_Solver::AlphaBeta(int depth, int alpha, int beta, typePlayer p
 
     // Handle Terminal Nodes: does player p win?
     if (s_board.IsWin((typePlayer)(p))) {
+        s_counters.Leaf();
         return color * ((MAX_BESTVAL - MoveNumber) / 2);
     }
 
     // if terminal node (i.e., no move to make) or depth = 0, return DRAW
     if ((depth == 0) || (s_board.IsNoMove())) {
+        s_counters.Leaf();
         return DRAW;
         //return DRAW + color * MoveNumber;
     }
 
     int bestVal = 0;
-    int moveVal = 0;
+    bool bFirstMove = true;     // for the statistics of move ordering
 
     if (isMaximizingPlayer) {
         bestVal = -MAX_BESTVAL;
@@ -192,15 +215,18 @@ int MinimaxABPlay_Solver::AlphaBeta(int depth, int alpha, int beta, typePlayer p
         for (int v : s_board.MoveSequence) {
             if (s_board.IsValidMove(v)) {
                 // process the move if it's valid
-                numberOfNodes++;
+                s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);
                 s_board.MakeMove(v, p);
 
                 bestVal = std::max(bestVal, AlphaBeta(depth - 1, alpha, beta, (typePlayer)(!playerToMove), !isMaximizingPlayer, MoveNumber+1));
 
                 s_board.TakeBackMove(v, p);
                 alpha = std::max(alpha, bestVal);
-                if (alpha >= beta)
+                if (alpha >= beta) {
+                    s_counters.Cutoff(bFirstMove);
                     break;
+                }
+                bFirstMove = false;
             }
         }
         return bestVal;
@@ -212,15 +238,18 @@ int MinimaxABPlay_Solver::AlphaBeta(int depth, int alpha, int beta, typePlayer p
         for (int v : s_board.MoveSequence) {
             if (s_board.IsValidMove(v)) {
                 // process the move if it's valid
-                numberOfNodes++;
+                s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);
                 s_board.MakeMove(v, p);
 
                 bestVal = std::min(bestVal, AlphaBeta(depth - 1, alpha, beta, (typePlayer)(!playerToMove), !isMaximizingPlayer, MoveNumber+1));
 
                 s_board.TakeBackMove(v, p);
                 beta = std::min(beta, bestVal);
-                if (beta <= alpha)
+                if (beta <= alpha) {
+                    s_counters.Cutoff(bFirstMove);
                     break;
+                }
+                bFirstMove = false;
             }
         }
         return bestVal;
@@ -241,12 +270,396 @@ int MinimaxABPlay_Solver::AlphaBeta(int depth, int alpha, int beta, typePlayer p
 /// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
 /// <returns></returns>
 Move MinimaxABPlay_Solver::SolveBoard(const Board& b, unsigned int max_depth, unsigned int MoveNumber) {
+    Move m;
     s_board.CopyBoard(b);
-    return GetBestMoveMinimaxAB(s_board.GetPlayerToMove(), max_depth, true, MoveNumber);
+    BeginSearch(MoveNumber);
+    BeginTrace(MoveNumber);
+
+    // If this search has been done before, skip it
+    if (ProbeSolveCache(max_depth, MoveNumber, m)) {
+        EndTrace(MoveNumber);
+        EndSearch();
+        return m;
+    }
+
+    if (C4_TRACE && bTrace)
+        SearchTrace::Begin(TRACE_ITERATION, max_depth);
+    m = GetBestMoveMinimaxAB(s_board.GetPlayerToMove(), max_depth, true, MoveNumber);
+    if (C4_TRACE && bTrace)
+        SearchTrace::End(TRACE_ITERATION, max_depth);
+    StoreSolveCache(max_depth, MoveNumber, m);
+    EndTrace(MoveNumber);
+    EndSearch();
+    return m;
 }
 Move MinimaxABPlay_Solver::SolveBoard(const Board& b, unsigned int MoveNumber) {
+    return SolveBoard(b, s_max_depth, MoveNumber);
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::SolveBoard() with a clock is used for tournament play under a time control.  The solver searches with iterative 
+/// deepening (depth 0, 1, ... up to its maximum depth) and keeps the move of the deepest completed search.  Its time budget for the move is an 
+/// equal share of the time left over the moves it may still have to play, plus most of the increment; it does not start a depth that is not
+/// expected to finish within the budget, and abandons a search that runs past a hard limit (a fraction of the time left).
+/// </summary>
+/// <param name="b">Board configuration to be searched</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <param name="clock">Time left on the solver's clock and increment per move</param>
+/// <returns>Best move</returns>
+Move MinimaxABPlay_Solver::SolveBoard(const Board& b, unsigned int MoveNumber, const SolverClock& clock) {
+    auto start = std::chrono::steady_clock::now();
+    s_board.CopyBoard(b);
+    BeginSearch(MoveNumber);
+    BeginTrace(MoveNumber);
+
+    unsigned int movesLeft = (MoveNumber < WIDTH * HEIGHT) ? (WIDTH * HEIGHT - MoveNumber + 1) / 2 : 1;
+    double budget_ms = clock.remaining_ms / movesLeft + 0.75 * clock.increment_ms;
+    double limit_ms = std::min(3.0 * budget_ms, 0.5 * clock.remaining_ms);
+
+    // Fall back on the first valid move if not even the shallowest search completes
+    Move bestMove = 0;
+    int bestScore = 0;
+    for (auto const& v : s_board.MoveSequence) {
+        if (s_board.IsValidMove(v)) {
+            bestMove = v;
+            break;
+        }
+    }
+
+    deadline = start + std::chrono::microseconds((long long)(1000.0 * limit_ms));
+    pollNodes = 0;
+    bCheckDeadline = true;
+    bStopped = false;
+    for (int depth = 0; depth <= s_max_depth; depth++) {
+        if (C4_TRACE && bTrace)
+            SearchTrace::Begin(TRACE_ITERATION, depth);
+        Move m = GetBestMoveMinimaxAB(s_board.GetPlayerToMove(), depth, true, MoveNumber);
+        if (C4_TRACE && bTrace)
+            SearchTrace::End(TRACE_ITERATION, depth);
+        if (bStopped)
+            break;
+        bestMove = m;
+        bestScore = s_lastScore;
+
+        double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed_ms * TIME_BRANCHING_FACTOR > budget_ms)
+            break;
+    }
+    bCheckDeadline = false;
+    bStopped = false;
+
+    s_lastScore = bestScore;
+    EndTrace(MoveNumber);
+    EndSearch();
+    return bestMove;
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::SolveBoardUntil() searches with iterative deepening (depth 0, 1, ... up to its maximum depth) until the last depth completes,
+/// the deadline passes or the token is cancelled; the clock and the token are polled every DEADLINE_POLL_NODES nodes, as in timed play.  The move
+/// returned is that of the deepest completed search, so a search that is stopped still returns its best move so far (the first valid move if not 
+/// even depth 0 completed).  As each depth searches about TIME_BRANCHING_FACTOR times as many nodes as the one before, the shallower depths add
+/// about a third to a search that runs to completion; a complete search gives the same move as SolveBoard() and is cached as SolveBoard() would be.
+/// </summary>
+/// <param name="b">Board configuration to be searched</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <param name="until">Time by which the search must stop</param>
+/// <param name="token">Token that cancels the search</param>
+/// <returns>Best move found, with its score and whether the search completed</returns>
+SolveResult MinimaxABPlay_Solver::SolveBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point until, 
+    const SearchToken& token) {
+    SolveResult r;
+    auto start = std::chrono::steady_clock::now();
     s_board.CopyBoard(b);
-    return GetBestMoveMinimaxAB(s_board.GetPlayerToMove(), s_max_depth, true, MoveNumber);
+    BeginSearch(MoveNumber);
+    BeginTrace(MoveNumber);
+
+    // Fall back on the first valid move if not even the shallowest search completes
+    for (auto const& v : s_board.MoveSequence) {
+        if (s_board.IsValidMove(v)) {
+            r.move = v;
+            break;
+        }
+    }
+
+    Move m;
+    if (ProbeSolveCache(s_max_depth, MoveNumber, m)) {
+        r.move = m;
+        r.score = s_lastScore;
+        r.bComplete = true;
+    }
+    else if (!token.IsCancelled() && (start < until)) {
+        deadline = until;
+        pToken = &token;
+        pollNodes = 0;
+        bCheckDeadline = true;
+        bStopped = false;
+        for (int depth = 0; depth <= s_max_depth; depth++) {
+            if (C4_TRACE && bTrace)
+                SearchTrace::Begin(TRACE_ITERATION, depth);
+            m = GetBestMoveMinimaxAB(s_board.GetPlayerToMove(), depth, true, MoveNumber);
+            if (C4_TRACE && bTrace)
+                SearchTrace::End(TRACE_ITERATION, depth);
+            if (bStopped)
+                break;
+            r.move = m;
+            r.score = s_lastScore;
+        }
+        r.bComplete = !bStopped;
+        bCheckDeadline = false;
+        bStopped = false;
+        pToken = nullptr;
+
+        s_lastScore = r.score;
+        if (r.bComplete)
+            StoreSolveCache(s_max_depth, MoveNumber, r.move);
+    }
+    EndTrace(MoveNumber);
+    EndSearch();
+    r.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return r;
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::AnalyzeBoard() scores every valid column in one search of the position.  The columns are searched in the board's move 
+/// sequence, as SolveBoard() does, and share the search's statistics, trace and board.  The reply that refuted one column is tried first 
+/// against the next (see SearchReplies()), which cuts most columns off sooner than SolveBoard(), whose replies are always searched in the move 
+/// sequence.  With bExact, each column is searched with the full window, so every score is exact; this costs about as much as SolveBoard() 
+/// (somewhat less, thanks to the refutations, unless SolveBoard() can stop at a win on the next move).  Otherwise, each column 
+/// after the first only has to beat the best score so far: a column that cannot is cut off early and scored SCORE_UPPER (its value is at most 
+/// that score), which is much cheaper (about a third of the nodes of SolveBoard() over the benchmark positions) when only the best column and
+/// its rivals matter.
+/// A column that wins is scored as SolveBoard() scores a win on the next move.  Variety of play is ignored (the analysis is deterministic).
+/// </summary>
+/// <param name="b">Board configuration to be analyzed</param>
+/// <param name="max_depth">Maximum Depth to search</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <param name="scores">Returns the score of each valid column, from the point of view of the player to move</param>
+/// <param name="bExact">true to score every column exactly; false to score only the best column exactly</param>
+/// <returns>Best move (the first column, in the move sequence, with the highest score); 0 if there is no valid move</returns>
+Move MinimaxABPlay_Solver::AnalyzeBoard(const Board& b, unsigned int max_depth, unsigned int MoveNumber, typeMoveScores& scores, bool bExact) {
+    s_board.CopyBoard(b);
+    BeginSearch(MoveNumber);
+    BeginTrace(MoveNumber);
+    if (C4_TRACE && bTrace)
+        SearchTrace::Begin(TRACE_ITERATION, max_depth);
+
+    typePlayer p = s_board.GetPlayerToMove();
+    MoveScore columns[WIDTH + 1];
+    Move bestMove = 0;
+    int alpha = -MAX_BESTVAL;
+    Move refutation = 0;
+    for (auto const& v : s_board.MoveSequence) {
+        if (!s_board.IsValidMove(v))
+            continue;
+        s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);
+        s_board.MakeMove(v, p);
+
+        MoveScore& column = columns[v];
+        column.move = v;
+        if (s_board.IsWin(p)) {
+            s_counters.Leaf();
+            column.score = (MAX_BESTVAL - MoveNumber) / 2;
+        }
+        else {
+            if (C4_TRACE && bTrace)
+                SearchTrace::Begin(TRACE_ROOT_MOVE, v);
+            column.score = SearchReplies(max_depth, bExact ? -MAX_BESTVAL : alpha, MAX_BESTVAL, (typePlayer)(!p), MoveNumber + 1, refutation);
+            if (C4_TRACE && bTrace)
+                SearchTrace::End(TRACE_ROOT_MOVE, v);
+            if (!bExact && (bestMove != 0) && (column.score <= alpha))
+                column.bound = SCORE_UPPER;
+        }
+        s_board.TakeBackMove(v, p);
+
+        // A stopped analysis (see AnalyzeBoardUntil()) keeps the columns scored so far
+        if (bStopped) {
+            column.move = 0;
+            break;
+        }
+
+        if ((bestMove == 0) || (column.score > columns[bestMove].score)) {
+            bestMove = v;
+            alpha = column.score;
+        }
+    }
+
+    scores.clear();
+    for (Move m = 1; m <= WIDTH; m++) {
+        if (columns[m].move != 0)
+            scores.push_back(columns[m]);
+    }
+    s_lastScore = (bestMove != 0) ? columns[bestMove].score : 0;
+
+    if (C4_TRACE && bTrace)
+        SearchTrace::End(TRACE_ITERATION, max_depth);
+    EndTrace(MoveNumber);
+    EndSearch();
+    return bestMove;
+}
+Move MinimaxABPlay_Solver::AnalyzeBoard(const Board& b, unsigned int MoveNumber, typeMoveScores& scores, bool bExact) {
+    return AnalyzeBoard(b, s_max_depth, MoveNumber, scores, bExact);
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::AnalyzeBoardUntil() scores every valid column (see AnalyzeBoard()) until the analysis completes, the deadline passes or
+/// the token is cancelled; the clock and the token are polled every DEADLINE_POLL_NODES nodes.  A stopped analysis returns the columns it had 
+/// scored (in the board's move sequence) and the best of them.
+/// </summary>
+/// <param name="b">Board configuration to be analyzed</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <param name="until">Time by which the analysis must stop</param>
+/// <param name="token">Token that cancels the analysis</param>
+/// <param name="scores">Returns the score of each column scored (every valid column if the analysis completed)</param>
+/// <param name="bExact">true to score every column exactly; false to score only the best column exactly</param>
+/// <returns>Best move of the columns scored (0 if none), with its score and whether the analysis completed</returns>
+SolveResult MinimaxABPlay_Solver::AnalyzeBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point until, 
+    const SearchToken& token, typeMoveScores& scores, bool bExact) {
+    SolveResult r;
+    auto start = std::chrono::steady_clock::now();
+    scores.clear();
+    if (token.IsCancelled() || (start >= until))
+        return r;
+
+    deadline = until;
+    pToken = &token;
+    pollNodes = 0;
+    bCheckDeadline = true;
+    bStopped = false;
+    r.move = AnalyzeBoard(b, s_max_depth, MoveNumber, scores, bExact);
+    r.score = s_lastScore;
+    r.bComplete = !bStopped;
+    bCheckDeadline = false;
+    bStopped = false;
+    pToken = nullptr;
+
+    r.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return r;
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::SearchReplies() searches the opponent's replies to a column for AnalyzeBoard(), as AlphaBeta() does for the minimizing 
+/// player, but tries the given reply first: the reply that refuted the previous column usually refutes the next one too, and a refutation 
+/// searched first cuts the other replies off sooner
+/// </summary>
+/// <param name="depth">Depth to search</param>
+/// <param name="alpha">alpha (Lower Bound)</param>
+/// <param name="beta">beta (Upper Bound)</param>
+/// <param name="playerToMove">Player To Move (the opponent)</param>
+/// <param name="MoveNumber">Used in the board evaluation</param>
+/// <param name="refutation">Reply to try first (0 for none); returns the best reply found (0 if there was none)</param>
+/// <returns>Value of the column</returns>
+int MinimaxABPlay_Solver::SearchReplies(int depth, int alpha, int beta, typePlayer playerToMove, unsigned int MoveNumber, Move& refutation) {
+    assert(alpha < beta);
+
+    typePlayer p = playerToMove;
+
+    if (C4_TRACE && bTraceNodes && ((++traceNodes % traceSampleEvery) == 0))
+        SearchTrace::Instant(TRACE_NODE, (int)(MoveNumber - s_rootMoveNumber));
+
+    if (s_board.IsWin(p)) {
+        s_counters.Leaf();
+        refutation = 0;
+        return -((MAX_BESTVAL - MoveNumber) / 2);
+    }
+    if ((depth == 0) || (s_board.IsNoMove())) {
+        s_counters.Leaf();
+        refutation = 0;
+        return DRAW;
+    }
+
+    // The refutation first, then the move sequence
+    Move replies[WIDTH];
+    unsigned int nReplies = 0;
+    if ((refutation != 0) && s_board.IsValidMove(refutation))
+        replies[nReplies++] = refutation;
+    for (auto const& v : s_board.MoveSequence) {
+        if ((v != refutation) && s_board.IsValidMove(v))
+            replies[nReplies++] = v;
+    }
+
+    int bestVal = MAX_BESTVAL;
+    Move bestReply = 0;
+    for (unsigned int i = 0; i < nReplies; i++) {
+        Move v = replies[i];
+        s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);
+        s_board.MakeMove(v, p);
+        int moveVal = AlphaBeta(depth - 1, alpha, beta, (typePlayer)(!playerToMove), true, MoveNumber + 1);
+        s_board.TakeBackMove(v, p);
+        if (moveVal < bestVal) {
+            bestVal = moveVal;
+            bestReply = v;
+        }
+        beta = std::min(beta, bestVal);
+        if (beta <= alpha) {
+            s_counters.Cutoff(i == 0);
+            break;
+        }
+    }
+    refutation = bestReply;
+    return bestVal;
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::SolveReply() searches the opponent's reply one ply shallower than SolveBoard(), so that Solver_ConnectFour::AnalyzeBoard() 
+/// searches each column to the same depth as SolveBoard() and AnalyzeBoard() do
+/// </summary>
+/// <param name="b">Board configuration after the column has been played</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <returns>Best reply</returns>
+Move MinimaxABPlay_Solver::SolveReply(const Board& b, unsigned int MoveNumber) {
+    return SolveBoard(b, (s_max_depth > 0) ? s_max_depth - 1 : 0, MoveNumber);
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::BeginTrace() starts the trace span of a search, if tracing is enabled (checked once per search)
+/// </summary>
+/// <param name="MoveNumber">Move number at the root of the search</param>
+void MinimaxABPlay_Solver::BeginTrace(unsigned int MoveNumber) {
+    bTrace = SearchTrace::IsEnabled();
+    traceSampleEvery = SearchTrace::SampleEvery();
+    bTraceNodes = bTrace && (traceSampleEvery > 0);
+    traceNodes = 0;
+    if (C4_TRACE && bTrace)
+        SearchTrace::Begin(TRACE_SOLVE, MoveNumber);
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::EndTrace() ends the trace span of a search
+/// </summary>
+/// <param name="MoveNumber">Move number at the root of the search</param>
+void MinimaxABPlay_Solver::EndTrace(unsigned int MoveNumber) {
+    if (C4_TRACE && bTrace)
+        SearchTrace::End(TRACE_SOLVE, MoveNumber);
+    bTrace = bTraceNodes = false;
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::Clone() returns a new solver with the same configuration, so that games can be played concurrently (one solver per thread).
+/// The caller owns (and deletes) the returned solver.
+/// </summary>
+/// <param name=""></param>
+/// <returns>Copy of this solver</returns>
+Solver_ConnectFour* MinimaxABPlay_Solver::Clone(void) const {
+    return new MinimaxABPlay_Solver(*this);
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::IsDeterministic() returns true unless variety of play is enabled (the only use of the randomizer)
+/// </summary>
+/// <param name=""></param>
+/// <returns>!bVarietyOfPlay</returns>
+bool MinimaxABPlay_Solver::IsDeterministic(void) const {
+    return !bVarietyOfPlay;
+}
+
+/// <summary>
+/// MinimaxABPlay_Solver::GetFingerprint() identifies the configuration of the solver: the algorithm, the maximum depth, and variety of play
+/// </summary>
+/// <param name=""></param>
+/// <returns>Fingerprint of the solver</returns>
+std::string MinimaxABPlay_Solver::GetFingerprint(void) const {
+    return "MinimaxAB(depth=" + std::to_string(s_max_depth) + (bVarietyOfPlay ? ",variety)" : ")");
 }
 
 //
@@ -349,8 +762,13 @@ void MinimaxABPlay_Solver::SelfPlayMatch(unsigned int nRuns, unsigned int max_de
     bShowMoveByMove = false;
     bShowWinner = false;
 
+    // Count hardware events (if the system provides them) along with the time
+    PerfCounters counters;
+    unsigned long long startNodes = GetNumberOfNodes();
+
     // Start the clock
     auto c_start_ms = std::chrono::steady_clock().now();
+    counters.Start();
 
     // Play the game rRuns times...
     for (unsigned int i = 0; i < nRuns; i++) {
@@ -377,6 +795,7 @@ void MinimaxABPlay_Solver::SelfPlayMatch(unsigned int nRuns, unsigned int max_de
     }
 
     // Stop the clock and calculate duration
+    PerfSample perf = counters.Stop();
     auto c_end_ms = std::chrono::steady_clock().now();
     std::chrono::milliseconds duration_ms = (std::chrono::duration_cast<std::chrono::milliseconds>)(c_end_ms - c_start_ms);
 
@@ -395,4 +814,10 @@ void MinimaxABPlay_Solver::SelfPlayMatch(unsigned int nRuns, unsigned int max_de
     std::cout << " Total Number Of Yellow Wins : " << yellowW << " [" << yellowP << "]\n";
     std::cout << " Total Number Of Draws : " << iTotalGames - (yellowW + redW) << " [" << drawP << "]\n";
 
+    // Hardware counters per node searched and per move played
+    if (counters.IsAvailable())
+        PerfCounters::PrintReport(std::cout, perf, (double)(GetNumberOfNodes() - startNodes), (double)iTotalNumberOfMoves);
+    else
+        std::cout << " Hardware counters not available: " << counters.GetError() << "\n";
+
 }
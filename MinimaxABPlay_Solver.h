@@ -15,7 +15,9 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
+#include <chrono>
 #include "Solver_ConnectFour.h"
+#include "SearchTrace.h"
 
 /// <summary>
 /// MinimaxABPlay_Solver is derived from Solver_ConnectFour and selects its moves using the minimax algorithm with alpha-beta pruning.
@@ -27,24 +29,50 @@ class MinimaxABPlay_Solver :
 private:
 	//std::string s_PlayerName = "Minimax Alpha-Beta Player";
 	unsigned long long int iTotalNumberOfMoves;
-	unsigned long long int numberOfNodes;
 	bool bVarietyOfPlay = false;
 	bool bShowMoveByMove = true;
 	bool bShowWinner = true;
 	int s_max_depth = 12;
 
+	// Timed search (see SolveBoard() with a clock, and SolveBoardUntil()): the search stops when the deadline has passed or the token is cancelled
+	bool bCheckDeadline = false;
+	bool bStopped = false;
+	unsigned long long pollNodes = 0;
+	const SearchToken* pToken = nullptr;
+
+	// Tracing (see SearchTrace.h): set at the start of each search
+	bool bTrace = false;
+	bool bTraceNodes = false;
+	unsigned long long traceNodes = 0;
+	unsigned int traceSampleEvery = 0;
+
+	void BeginTrace(unsigned int MoveNumber);
+	void EndTrace(unsigned int MoveNumber);
+	std::chrono::steady_clock::time_point deadline;
 	
 	Move GetBestMove(typePlayer playerToMove, unsigned int max_depth, bool isMaximizingPlayer, MoveHistory* mh);
 	Move GetBestMoveMinimaxAB(typePlayer playerToMove, unsigned int max_depth, bool isMaximizingPlayer, unsigned int MoveNumber);
 	int AlphaBeta(int depth, int alpha, int beta, typePlayer playerToMove, bool isMaximizingPlayer, unsigned int MoveNumber);
+	int SearchReplies(int depth, int alpha, int beta, typePlayer playerToMove, unsigned int MoveNumber, Move& refutation);
+	Move SolveReply(const Board& b, unsigned int MoveNumber);
 	
 
 public:
 	//std::string GetPlayerName(void);
 	//void SetPlayerName(std::string s);
 	MinimaxABPlay_Solver(int max_depth = 12, bool bVariety = false);
+	using Solver_ConnectFour::SolveBoard;
 	Move SolveBoard(const Board& b, unsigned int max_depth, unsigned int MoveNumber);
 	Move SolveBoard(const Board& b, unsigned int MoveNumber);
+	Move SolveBoard(const Board& b, unsigned int MoveNumber, const SolverClock& clock);
+	SolveResult SolveBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point until, const SearchToken& token);
+	Move AnalyzeBoard(const Board& b, unsigned int max_depth, unsigned int MoveNumber, typeMoveScores& scores, bool bExact = true);
+	Move AnalyzeBoard(const Board& b, unsigned int MoveNumber, typeMoveScores& scores, bool bExact = true);
+	SolveResult AnalyzeBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point until, const SearchToken& token, 
+		typeMoveScores& scores, bool bExact = true);
+	Solver_ConnectFour* Clone(void) const;
+	bool IsDeterministic(void) const;
+	std::string GetFingerprint(void) const;
 	int SelfPlay(typePlayer playerToMove, unsigned int max_depth);
 	void SelfPlayMatch(unsigned int nRuns, unsigned int max_depth);
 };
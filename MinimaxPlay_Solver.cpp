@@ -16,8 +16,10 @@
 */
 #include <iostream>
 #include <chrono>
+#include <algorithm>
 #include "Solver_ConnectFour.h"
 #include "MinimaxPlay_Solver.h"
+#include "PerfCounters.h"
 
 #define MAX_BESTVAL (WIDTH * (HEIGHT + 1))
 // #define MIN_SCORE (-(WIDTH * HEIGHT) / 2 + 3)
@@ -25,6 +27,8 @@
 #define WIN 10000
 #define LOSS -10000
 #define MAX_DEPTH 8
+#define DEADLINE_POLL_NODES 1024    // in a search that can be stopped, the clock and the cancellation token are checked every DEADLINE_POLL_NODES nodes
+#define TIME_BRANCHING_FACTOR WIDTH // assumed growth of the search time from one depth to the next (iterative deepening, no pruning)
 
 //
 // Constructor and Initializers
@@ -40,7 +44,6 @@ MinimaxPlay_Solver::MinimaxPlay_Solver(int md, bool bVariety) : Solver_ConnectFo
     s_max_depth = md;
     bVarietyOfPlay = bVariety;
     iTotalNumberOfMoves = 0;
-    numberOfNodes = 0;
     bShowMoveByMove = true;
     bShowWinner = true;
     SetPlayerName("Minimax Connect Four Player");
@@ -60,7 +63,10 @@ MinimaxPlay_Solver::MinimaxPlay_Solver(int md, bool bVariety) : Solver_ConnectFo
 /// <param name="mh">Move History (needed for current number of moves)</param>
 /// <returns>Best Move</returns>
 Move MinimaxPlay_Solver::GetBestMove(typePlayer playerToMove, unsigned int max_depth, bool isMaximizingPlayer, MoveHistory *mh) {
-    return GetBestMoveMinimax(playerToMove, max_depth, isMaximizingPlayer, mh->NumberOfMoves());
+    BeginSearch(mh->NumberOfMoves());
+    Move m = GetBestMoveMinimax(playerToMove, max_depth, isMaximizingPlayer, mh->NumberOfMoves());
+    EndSearch();
+    return m;
 }
 
 /// <summary>
@@ -104,7 +110,7 @@ Move MinimaxPlay_Solver::GetBestMoveMinimax(typePlayer playerToMove, unsigned in
         for (auto const& v : s_board.MoveSequence) {
             if (s_board.IsValidMove(v)) {
                 // If the possible move is valid, 
-                numberOfNodes++;    // capture statistics of number of Nodes visited
+                s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);    // capture statistics of number of Nodes visited
                 
                 // ... Make the  Move...
                 s_board.MakeMove(v, p);
@@ -114,7 +120,7 @@ Move MinimaxPlay_Solver::GetBestMoveMinimax(typePlayer playerToMove, unsigned in
 
                 // ... add some noise to the moveVal if it is equal to bestVal ...
                 if ((moveVal == bestVal) && (bVarietyOfPlay)) {
-                    moveVal += (-1 + 2 * ((float)rand()) / (float)RAND_MAX);
+                    moveVal += (-1 + 2 * s_rng.NextDouble());
                 }
 
                 // ... Keep the best Move ...
@@ -135,7 +141,8 @@ Move MinimaxPlay_Solver::GetBestMoveMinimax(typePlayer playerToMove, unsigned in
             }
         }
     }
-    // Return the bestMove
+    // Keep the score of the bestMove and return the bestMove
+    s_lastScore = (int)bestVal;
     return bestMove;
 }
 
@@ -153,6 +160,13 @@ int MinimaxPlay_Solver::Minimax(int depth, typePlayer playerToMove, bool isMaxim
     int color;
 
     color = isMaximizingPlayer ? 1 : -1;
+
+    // Search that can be stopped: give up once the deadline has passed or the search is cancelled (the caller discards the result)
+    if (bCheckDeadline && ((++pollNodes % DEADLINE_POLL_NODES) == 0) && 
+        ((pToken && pToken->IsCancelled()) || (std::chrono::steady_clock::now() >= deadline)))
+        bStopped = true;
+    if (bStopped)
+        return DRAW;
     /*
     if (isMaximizingPlayer) {
         color = 1;
@@ -164,11 +178,13 @@ int MinimaxPlay_Solver::Minimax(int depth, typePlayer playerToMove, bool isMaxim
 
     // Handle Terminal Nodes: does player p win?
     if (s_board.IsWin((typePlayer)(p))) {
+        s_counters.Leaf();
         return color * ((MAX_BESTVAL - MoveNumber) / 2);
     }
 
     // if terminal node (i.e., no move to make) or depth = 0, return DRAW
     if ((depth == 0) || (s_board.IsNoMove())) {
+        s_counters.Leaf();
         return DRAW;
     }
 
@@ -181,7 +197,7 @@ int MinimaxPlay_Solver::Minimax(int depth, typePlayer playerToMove, bool isMaxim
         for (int v : s_board.MoveSequence) {
             if (s_board.IsValidMove(v)) {
                 // process the move if it's valid
-                numberOfNodes++;
+                s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);
                 s_board.MakeMove(v, p);
 
                 bestVal = std::max(bestVal, Minimax(depth - 1, (typePlayer)(!playerToMove), !(isMaximizingPlayer), MoveNumber+1));
@@ -198,7 +214,7 @@ int MinimaxPlay_Solver::Minimax(int depth, typePlayer playerToMove, bool isMaxim
         for (int v : s_board.MoveSequence) {
             if (s_board.IsValidMove(v)) {
                 // process the move if it's valid
-                numberOfNodes++;
+                s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);
                 s_board.MakeMove(v, p);
 
                 bestVal = std::min(bestVal, Minimax(depth - 1, (typePlayer)(!playerToMove), !isMaximizingPlayer, MoveNumber+1));
@@ -223,12 +239,269 @@ int MinimaxPlay_Solver::Minimax(int depth, typePlayer playerToMove, bool isMaxim
 /// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
 /// <returns></returns>
 Move MinimaxPlay_Solver::SolveBoard(const Board& b, unsigned int MoveNumber) {
-    s_board.CopyBoard(b);
-    return GetBestMoveMinimax(s_board.GetPlayerToMove(), s_max_depth, true, MoveNumber);
+    return SolveBoard(b, s_max_depth, MoveNumber);
 }
 Move MinimaxPlay_Solver::SolveBoard(const Board& b, unsigned int max_depth, unsigned int MoveNumber) {
+    Move m;
+    s_board.CopyBoard(b);
+    BeginSearch(MoveNumber);
+
+    // If this search has been done before, skip it
+    if (ProbeSolveCache(max_depth, MoveNumber, m)) {
+        EndSearch();
+        return m;
+    }
+
+    m = GetBestMoveMinimax(s_board.GetPlayerToMove(), max_depth, true, MoveNumber);
+    StoreSolveCache(max_depth, MoveNumber, m);
+    EndSearch();
+    return m;
+}
+
+/// <summary>
+/// MinimaxPlay_Solver::SolveBoard() with a clock is used for tournament play under a time control, with the same time budget as 
+/// MinimaxABPlay_Solver: iterative deepening up to the maximum depth, keeping the move of the deepest completed search.  The budget for the 
+/// move is an equal share of the time left over the moves the solver may still have to play, plus most of the increment; a depth is not started
+/// if it is not expected to finish within the budget (each depth costs about WIDTH times the one before), and a search that runs past a hard 
+/// limit (a fraction of the time left) is abandoned.
+/// </summary>
+/// <param name="b">Board configuration to be searched</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <param name="clock">Time left on the solver's clock and increment per move</param>
+/// <returns>Best move</returns>
+Move MinimaxPlay_Solver::SolveBoard(const Board& b, unsigned int MoveNumber, const SolverClock& clock) {
+    auto start = std::chrono::steady_clock::now();
+    s_board.CopyBoard(b);
+    BeginSearch(MoveNumber);
+
+    unsigned int movesLeft = (MoveNumber < WIDTH * HEIGHT) ? (WIDTH * HEIGHT - MoveNumber + 1) / 2 : 1;
+    double budget_ms = clock.remaining_ms / movesLeft + 0.75 * clock.increment_ms;
+    double limit_ms = std::min(3.0 * budget_ms, 0.5 * clock.remaining_ms);
+
+    // Fall back on the first valid move if not even the shallowest search completes
+    Move bestMove = 0;
+    int bestScore = 0;
+    for (auto const& v : s_board.MoveSequence) {
+        if (s_board.IsValidMove(v)) {
+            bestMove = v;
+            break;
+        }
+    }
+
+    deadline = start + std::chrono::microseconds((long long)(1000.0 * limit_ms));
+    pollNodes = 0;
+    bCheckDeadline = true;
+    bStopped = false;
+    for (int depth = 0; depth <= s_max_depth; depth++) {
+        Move m = GetBestMoveMinimax(s_board.GetPlayerToMove(), depth, true, MoveNumber);
+        if (bStopped)
+            break;
+        bestMove = m;
+        bestScore = s_lastScore;
+
+        double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed_ms * TIME_BRANCHING_FACTOR > budget_ms)
+            break;
+    }
+    bCheckDeadline = false;
+    bStopped = false;
+
+    s_lastScore = bestScore;
+    EndSearch();
+    return bestMove;
+}
+
+/// <summary>
+/// MinimaxPlay_Solver::SolveBoardUntil() searches with iterative deepening (depth 0, 1, ... up to its maximum depth) until the last depth completes,
+/// the deadline passes or the token is cancelled; the clock and the token are polled every DEADLINE_POLL_NODES nodes.  The move returned is that 
+/// of the deepest completed search, so a search that is stopped still returns its best move so far (the first valid move if not even depth 0 
+/// completed).  Without pruning, each depth searches about WIDTH times as many nodes as the one before, so the shallower depths add about a sixth
+/// to a search that runs to completion; a complete search gives the same move as SolveBoard() and is cached as SolveBoard() would be.
+/// </summary>
+/// <param name="b">Board configuration to be searched</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <param name="until">Time by which the search must stop</param>
+/// <param name="token">Token that cancels the search</param>
+/// <returns>Best move found, with its score and whether the search completed</returns>
+SolveResult MinimaxPlay_Solver::SolveBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point until, 
+    const SearchToken& token) {
+    SolveResult r;
+    auto start = std::chrono::steady_clock::now();
+    s_board.CopyBoard(b);
+    BeginSearch(MoveNumber);
+
+    // Fall back on the first valid move if not even the shallowest search completes
+    for (auto const& v : s_board.MoveSequence) {
+        if (s_board.IsValidMove(v)) {
+            r.move = v;
+            break;
+        }
+    }
+
+    Move m;
+    if (ProbeSolveCache(s_max_depth, MoveNumber, m)) {
+        r.move = m;
+        r.score = s_lastScore;
+        r.bComplete = true;
+    }
+    else if (!token.IsCancelled() && (start < until)) {
+        deadline = until;
+        pToken = &token;
+        pollNodes = 0;
+        bCheckDeadline = true;
+        bStopped = false;
+        for (int depth = 0; depth <= s_max_depth; depth++) {
+            m = GetBestMoveMinimax(s_board.GetPlayerToMove(), depth, true, MoveNumber);
+            if (bStopped)
+                break;
+            r.move = m;
+            r.score = s_lastScore;
+        }
+        r.bComplete = !bStopped;
+        bCheckDeadline = false;
+        bStopped = false;
+        pToken = nullptr;
+
+        s_lastScore = r.score;
+        if (r.bComplete)
+            StoreSolveCache(s_max_depth, MoveNumber, r.move);
+    }
+    EndSearch();
+    r.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return r;
+}
+
+/// <summary>
+/// MinimaxPlay_Solver::AnalyzeBoard() scores every valid column in one search of the position: minimax already finds the exact value of each 
+/// column at the root, so every score is exact (bExact is ignored).  Minimax visits every position up to the maximum depth, so there is no work 
+/// to share between the columns: the analysis costs the same as SolveBoard(), or more when SolveBoard() can stop at a win on the next move.  
+/// A column that wins is scored as SolveBoard() scores a win on the next move.  Variety of play is ignored (the analysis is deterministic).
+/// </summary>
+/// <param name="b">Board configuration to be analyzed</param>
+/// <param name="max_depth">Maximum Depth to search</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <param name="scores">Returns the score of each valid column, from the point of view of the player to move</param>
+/// <param name="bExact">Ignored (every score is exact)</param>
+/// <returns>Best move (the first column, in the move sequence, with the highest score); 0 if there is no valid move</returns>
+Move MinimaxPlay_Solver::AnalyzeBoard(const Board& b, unsigned int max_depth, unsigned int MoveNumber, typeMoveScores& scores, bool) {
     s_board.CopyBoard(b);
-    return GetBestMoveMinimax(s_board.GetPlayerToMove(), max_depth, true, MoveNumber);
+    BeginSearch(MoveNumber);
+
+    typePlayer p = s_board.GetPlayerToMove();
+    MoveScore columns[WIDTH + 1];
+    Move bestMove = 0;
+    for (auto const& v : s_board.MoveSequence) {
+        if (!s_board.IsValidMove(v))
+            continue;
+        s_counters.Node(MoveNumber + 1 - s_rootMoveNumber);
+        s_board.MakeMove(v, p);
+
+        MoveScore& column = columns[v];
+        column.move = v;
+        if (s_board.IsWin(p)) {
+            s_counters.Leaf();
+            column.score = (MAX_BESTVAL - MoveNumber) / 2;
+        }
+        else
+            column.score = Minimax(max_depth, (typePlayer)(!p), false, MoveNumber + 1);
+        s_board.TakeBackMove(v, p);
+
+        // A stopped analysis (see AnalyzeBoardUntil()) keeps the columns scored so far
+        if (bStopped) {
+            column.move = 0;
+            break;
+        }
+
+        if ((bestMove == 0) || (column.score > columns[bestMove].score))
+            bestMove = v;
+    }
+
+    scores.clear();
+    for (Move m = 1; m <= WIDTH; m++) {
+        if (columns[m].move != 0)
+            scores.push_back(columns[m]);
+    }
+    s_lastScore = (bestMove != 0) ? columns[bestMove].score : 0;
+    EndSearch();
+    return bestMove;
+}
+Move MinimaxPlay_Solver::AnalyzeBoard(const Board& b, unsigned int MoveNumber, typeMoveScores& scores, bool bExact) {
+    return AnalyzeBoard(b, s_max_depth, MoveNumber, scores, bExact);
+}
+
+/// <summary>
+/// MinimaxPlay_Solver::AnalyzeBoardUntil() scores every valid column (see AnalyzeBoard()) until the analysis completes, the deadline passes or
+/// the token is cancelled; the clock and the token are polled every DEADLINE_POLL_NODES nodes.  A stopped analysis returns the columns it had 
+/// scored (in the board's move sequence) and the best of them.
+/// </summary>
+/// <param name="b">Board configuration to be analyzed</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <param name="until">Time by which the analysis must stop</param>
+/// <param name="token">Token that cancels the analysis</param>
+/// <param name="scores">Returns the score of each column scored (every valid column if the analysis completed)</param>
+/// <param name="bExact">Ignored (every score is exact)</param>
+/// <returns>Best move of the columns scored (0 if none), with its score and whether the analysis completed</returns>
+SolveResult MinimaxPlay_Solver::AnalyzeBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point until, 
+    const SearchToken& token, typeMoveScores& scores, bool bExact) {
+    SolveResult r;
+    auto start = std::chrono::steady_clock::now();
+    scores.clear();
+    if (token.IsCancelled() || (start >= until))
+        return r;
+
+    deadline = until;
+    pToken = &token;
+    pollNodes = 0;
+    bCheckDeadline = true;
+    bStopped = false;
+    r.move = AnalyzeBoard(b, s_max_depth, MoveNumber, scores, bExact);
+    r.score = s_lastScore;
+    r.bComplete = !bStopped;
+    bCheckDeadline = false;
+    bStopped = false;
+    pToken = nullptr;
+
+    r.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return r;
+}
+
+/// <summary>
+/// MinimaxPlay_Solver::SolveReply() searches the opponent's reply one ply shallower than SolveBoard(), so that Solver_ConnectFour::AnalyzeBoard() 
+/// searches each column to the same depth as SolveBoard() and AnalyzeBoard() do
+/// </summary>
+/// <param name="b">Board configuration after the column has been played</param>
+/// <param name="MoveNumber">Current MoveNumber (used in the evaluation function of the solver)</param>
+/// <returns>Best reply</returns>
+Move MinimaxPlay_Solver::SolveReply(const Board& b, unsigned int MoveNumber) {
+    return SolveBoard(b, (s_max_depth > 0) ? s_max_depth - 1 : 0, MoveNumber);
+}
+
+/// <summary>
+/// MinimaxPlay_Solver::Clone() returns a new solver with the same configuration, so that games can be played concurrently (one solver per thread).
+/// The caller owns (and deletes) the returned solver.
+/// </summary>
+/// <param name=""></param>
+/// <returns>Copy of this solver</returns>
+Solver_ConnectFour* MinimaxPlay_Solver::Clone(void) const {
+    return new MinimaxPlay_Solver(*this);
+}
+
+/// <summary>
+/// MinimaxPlay_Solver::IsDeterministic() returns true unless variety of play is enabled (the only use of the randomizer)
+/// </summary>
+/// <param name=""></param>
+/// <returns>!bVarietyOfPlay</returns>
+bool MinimaxPlay_Solver::IsDeterministic(void) const {
+    return !bVarietyOfPlay;
+}
+
+/// <summary>
+/// MinimaxPlay_Solver::GetFingerprint() identifies the configuration of the solver: the algorithm, the maximum depth, and variety of play
+/// </summary>
+/// <param name=""></param>
+/// <returns>Fingerprint of the solver</returns>
+std::string MinimaxPlay_Solver::GetFingerprint(void) const {
+    return "Minimax(depth=" + std::to_string(s_max_depth) + (bVarietyOfPlay ? ",variety)" : ")");
 }
 
 //
@@ -336,8 +609,13 @@ void MinimaxPlay_Solver::SelfPlayMatch(unsigned int nRuns, unsigned int max_dept
     bShowMoveByMove = false;
     bShowWinner = false;
 
+    // Count hardware events (if the system provides them) along with the time
+    PerfCounters counters;
+    unsigned long long startNodes = GetNumberOfNodes();
+
     // Start the clock
     auto c_start_ms = std::chrono::steady_clock().now();
+    counters.Start();
 
     // Play the game rRuns times...
     for (unsigned int i = 0; i < nRuns; i++) {
@@ -364,6 +642,7 @@ void MinimaxPlay_Solver::SelfPlayMatch(unsigned int nRuns, unsigned int max_dept
     }
 
     // Stop the clock and calculate duration
+    PerfSample perf = counters.Stop();
     auto c_end_ms = std::chrono::steady_clock().now();
     std::chrono::milliseconds duration_ms = (std::chrono::duration_cast<std::chrono::milliseconds>)(c_end_ms - c_start_ms);
 
@@ -382,4 +661,10 @@ void MinimaxPlay_Solver::SelfPlayMatch(unsigned int nRuns, unsigned int max_dept
     std::cout << " Total Number Of Yellow Wins : " << yellowW << " [" << yellowP << "]\n";
     std::cout << " Total Number Of Draws : " << iTotalGames - (yellowW + redW) << " [" << drawP << "]\n";
 
+    // Hardware counters per node searched and per move played
+    if (counters.IsAvailable())
+        PerfCounters::PrintReport(std::cout, perf, (double)(GetNumberOfNodes() - startNodes), (double)iTotalNumberOfMoves);
+    else
+        std::cout << " Hardware counters not available: " << counters.GetError() << "\n";
+
 }
\ No newline at end of file
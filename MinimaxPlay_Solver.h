@@ -15,6 +15,7 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
+#include <chrono>
 #include "Solver_ConnectFour.h"
 
 /// <summary>
@@ -26,21 +27,38 @@ class MinimaxPlay_Solver :
 {
 private:
 	unsigned long long int iTotalNumberOfMoves;
-	unsigned long long int numberOfNodes;
 	bool bVarietyOfPlay;
 	bool bShowMoveByMove;
 	bool bShowWinner;
 	int s_max_depth;
 
+	// Search that can be stopped (see SolveBoardUntil()): the search stops when the deadline has passed or the token is cancelled
+	bool bCheckDeadline = false;
+	bool bStopped = false;
+	unsigned long long pollNodes = 0;
+	const SearchToken* pToken = nullptr;
+	std::chrono::steady_clock::time_point deadline;
+
 	Move GetBestMove(typePlayer playerToMove, unsigned int max_depth, bool isMaximizingPlayer, MoveHistory* mh);
 	Move GetBestMoveMinimax(typePlayer playerToMove, unsigned int max_depth, bool isMaximizingColor, unsigned int MoveNumber);
 	int Minimax(int depth, typePlayer playerToMove, bool isMaximizingPlayer, unsigned int MoveNumber);
+	Move SolveReply(const Board& b, unsigned int MoveNumber);
 
 public:
 	MinimaxPlay_Solver (int md = 8, bool bVariety = false);
 
+	using Solver_ConnectFour::SolveBoard;
 	Move SolveBoard(const Board& b, unsigned int MoveNumber);
 	Move SolveBoard(const Board& b, unsigned int max_depth, unsigned int MoveNumber);
+	Move SolveBoard(const Board& b, unsigned int MoveNumber, const SolverClock& clock);
+	SolveResult SolveBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point until, const SearchToken& token);
+	Move AnalyzeBoard(const Board& b, unsigned int max_depth, unsigned int MoveNumber, typeMoveScores& scores, bool bExact = true);
+	Move AnalyzeBoard(const Board& b, unsigned int MoveNumber, typeMoveScores& scores, bool bExact = true);
+	SolveResult AnalyzeBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point until, const SearchToken& token, 
+		typeMoveScores& scores, bool bExact = true);
+	Solver_ConnectFour* Clone(void) const;
+	bool IsDeterministic(void) const;
+	std::string GetFingerprint(void) const;
 	
 	int SelfPlay(typePlayer playerToMove, unsigned int max_depth);
 	void SelfPlayMatch(unsigned int nRuns, unsigned int max_depth);
@@ -16,9 +16,10 @@
 */
 #include <iostream>
 #include "MoveHistory.h"
+#include "GameRecord.h"
 
 /// <summary>
-/// MoveHistory::AddMove() adds a move to the back of the vector.
+/// MoveHistory::AddMove() adds a move to the back of the move history.
 /// </summary>
 /// <param name="m">Move to add to the move history</param>
 void MoveHistory::AddMove(Move m) {
@@ -34,7 +35,7 @@ void MoveHistory::RemoveMove(void) {
 }
 
 /// <summary>
-/// MoveHistory::ResetHistory() clears the move history (i.e., clears the vector)
+/// MoveHistory::ResetHistory() clears the move history
 /// </summary>
 /// <param name=""></param>
 /// <returns></returns>
@@ -47,8 +48,17 @@ void MoveHistory::ResetHistory(void) {
 /// </summary>
 /// <param name=""></param>
 /// <returns>Moves.size()</returns>
-unsigned int MoveHistory::NumberOfMoves(void) {
-	return Moves.size();
+unsigned int MoveHistory::NumberOfMoves(void) const {
+	return (unsigned int)Moves.size();
+}
+
+/// <summary>
+/// MoveHistory::GetMove() returns a move of the move history
+/// </summary>
+/// <param name="i">Index of the move (0 = first move)</param>
+/// <returns>Move</returns>
+Move MoveHistory::GetMove(unsigned int i) const {
+	return Moves[i];
 }
 
 /// <summary>
@@ -56,10 +66,44 @@ unsigned int MoveHistory::NumberOfMoves(void) {
 /// </summary>
 /// <param name=""></param>
 void MoveHistory::PrintMoveHistory(void) {
+	PrintMoveHistory(std::cout);
+}
+
+/// <summary>
+/// MoveHistory::PrintMoveHistory() writes the move history (i.e., all moves added to move history) to the specified stream
+/// </summary>
+/// <param name="out">Stream to write to</param>
+void MoveHistory::PrintMoveHistory(std::ostream& out) {
 	
-	std::cout << std::endl << "MOVE HISTORY: ";
+	out << std::endl << "MOVE HISTORY: ";
 	for (t_MoveHistory::iterator m_it = Moves.begin(); m_it != Moves.end(); m_it++) {
-		std::cout << *m_it << " ";
+		out << *m_it << " ";
 	}
-	std::cout << std::endl;
-}
\ No newline at end of file
+	out << std::endl;
+}
+
+/// <summary>
+/// MoveHistory::Serialize() writes the move history as a game record: a header byte (number of moves, result) followed by the moves, 3 bits each
+/// </summary>
+/// <param name="out">Record (at least GAMERECORD_MAX_BYTES)</param>
+/// <param name="result">Result of the game</param>
+/// <returns>Size of the record, or 0 if the moves are not a valid game</returns>
+size_t MoveHistory::Serialize(uint8_t* out, t_GameResult result) const {
+	return EncodeGame(Moves.data(), (unsigned int)Moves.size(), result, out);
+}
+
+/// <summary>
+/// MoveHistory::Deserialize() replaces the move history with the moves of a game record
+/// </summary>
+/// <param name="in">Record</param>
+/// <param name="available">Number of bytes available at in</param>
+/// <param name="result">Returns the result of the game</param>
+/// <returns>Size of the record, or 0 if it is incomplete or not valid (the move history is then unchanged)</returns>
+size_t MoveHistory::Deserialize(const uint8_t* in, size_t available, t_GameResult& result) {
+	Move moves[WIDTH * HEIGHT];
+	unsigned int nMoves;
+	size_t size = DecodeGame(in, available, moves, nMoves, result);
+	if (size != 0)
+		Moves.assign(moves, moves + nMoves);
+	return size;
+}
@@ -15,13 +15,18 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
-#include<vector>
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include "Board.h"
+#include "FixedVector.h"
 
-typedef unsigned int Move;
-typedef std::vector <Move> t_MoveHistory;
+typedef FixedVector <Move, WIDTH * HEIGHT> t_MoveHistory;	// a game has at most WIDTH * HEIGHT moves
+enum t_GameResult : int;	// see GameRecord.h
 
 /// <summary>
-/// MoveHistory allows one to track the moves played in a game.  This implementation uses a vector to store the moves and assumes players alternate moves.
+/// MoveHistory allows one to track the moves played in a game.  This implementation stores the moves in place (a FixedVector: no memory 
+/// allocation, so it can be used on the per-move path of a game) and assumes players alternate moves.
 /// </summary>
 class MoveHistory
 {
@@ -32,7 +37,13 @@ public:
 	void AddMove(Move m);
 	void RemoveMove(void);
 	void ResetHistory(void);
-	unsigned int NumberOfMoves(void);
+	unsigned int NumberOfMoves(void) const;
+	Move GetMove(unsigned int i) const;
 	void PrintMoveHistory(void);
+	void PrintMoveHistory(std::ostream& out);
+
+	// Compact binary form (see GameRecord.h)
+	size_t Serialize(uint8_t* out, t_GameResult result) const;
+	size_t Deserialize(const uint8_t* in, size_t available, t_GameResult& result);
 };
 
@@ -0,0 +1,103 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include "MoveStats.h"
+
+/// <summary>
+/// MoveStats::Add() adds the timing of one move
+/// </summary>
+/// <param name="solver">Solver that played the move (e.g., its fingerprint)</param>
+/// <param name="moveNumber">Number of moves played before this one</param>
+/// <param name="time_ms">Time taken by SolveBoard(), in milliseconds</param>
+/// <param name="nodes">Nodes searched for the move</param>
+void MoveStats::Add(const std::string& solver, unsigned int moveNumber, double time_ms, unsigned long long nodes) {
+	size_t s = std::find(m_solvers.begin(), m_solvers.end(), solver) - m_solvers.begin();
+	if (s == m_solvers.size()) {
+		m_solvers.push_back(solver);
+		m_samples.emplace_back();
+	}
+	if (m_samples[s].size() <= moveNumber)
+		m_samples[s].resize(moveNumber + 1);
+	m_samples[s][moveNumber].push_back({ time_ms, nodes });
+}
+
+/// <summary>
+/// MoveStats::Clear() removes all timings
+/// </summary>
+void MoveStats::Clear(void) {
+	m_solvers.clear();
+	m_samples.clear();
+}
+
+/// <summary>
+/// MoveStats::IsEmpty() returns true if no timing has been added
+/// </summary>
+bool MoveStats::IsEmpty(void) const {
+	return m_solvers.empty();
+}
+
+/// <summary>
+/// MoveStats::PrintRow() prints one line of the summary: number of moves, latency percentiles (nearest rank), nodes per move and nodes per second
+/// </summary>
+void MoveStats::PrintRow(std::ostream& out, const std::string& label, std::vector<Sample>& samples) {
+	std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.time_ms < b.time_ms; });
+	auto percentile = [&](double p) {
+		size_t rank = (size_t)std::ceil(p * samples.size());
+		return samples[(rank == 0) ? 0 : rank - 1].time_ms;
+	};
+
+	double totalTime_ms = 0.0;
+	unsigned long long totalNodes = 0;
+	for (const Sample& s : samples) {
+		totalTime_ms += s.time_ms;
+		totalNodes += s.nodes;
+	}
+
+	out << std::left << std::setw(36) << label << std::right << std::setw(8) << samples.size() << std::fixed << std::setprecision(3)
+		<< std::setw(11) << percentile(0.50) << std::setw(11) << percentile(0.90) << std::setw(11) << percentile(0.99) << std::setw(11) << samples.back().time_ms
+		<< std::setprecision(0) << std::setw(13) << (double)totalNodes / samples.size()
+		<< std::setw(14) << ((totalTime_ms > 0) ? 1000.0 * totalNodes / totalTime_ms : 0.0) << std::endl;
+	out.unsetf(std::ios::fixed);
+	out << std::setprecision(6);
+}
+
+/// <summary>
+/// MoveStats::PrintSummary() prints, for each solver, the statistics of all its moves and (optionally) of its moves at each move number
+/// </summary>
+/// <param name="out">Stream to print to</param>
+/// <param name="bPerMoveNumber">Also print one line per move number</param>
+void MoveStats::PrintSummary(std::ostream& out, bool bPerMoveNumber) const {
+	out << std::left << std::setw(36) << "Move Statistics" << std::right << std::setw(8) << "Moves" << std::setw(11) << "p50 ms" << std::setw(11) << "p90 ms"
+		<< std::setw(11) << "p99 ms" << std::setw(11) << "max ms" << std::setw(13) << "Nodes/Move" << std::setw(14) << "Nodes/sec" << std::endl;
+
+	for (size_t s = 0; s < m_solvers.size(); s++) {
+		std::vector<Sample> all;
+		for (const std::vector<Sample>& samples : m_samples[s])
+			all.insert(all.end(), samples.begin(), samples.end());
+		PrintRow(out, m_solvers[s], all);
+
+		if (bPerMoveNumber) {
+			for (size_t moveNumber = 0; moveNumber < m_samples[s].size(); moveNumber++) {
+				std::vector<Sample> samples = m_samples[s][moveNumber];
+				if (!samples.empty())
+					PrintRow(out, "  move " + std::to_string(moveNumber), samples);
+			}
+		}
+	}
+}
@@ -0,0 +1,54 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <iostream>
+#include "Board.h"
+
+/// <summary>
+/// MoveTiming is the cost of one move of a game: how long SolveBoard() took and how many nodes the solver searched
+/// </summary>
+struct MoveTiming {
+	unsigned int moveNumber = 0;	// number of moves played before this one
+	typePlayer player = RED;
+	double time_ms = 0.0;
+	unsigned long long nodes = 0;
+};
+
+/// <summary>
+/// MoveStats collects the move timings of many games, per solver and per move number, and summarizes them as latency percentiles
+/// (p50 / p90 / p99 / max), nodes per move and nodes per second.  Every sample is kept, so the percentiles are exact.
+/// </summary>
+class MoveStats
+{
+private:
+	struct Sample {
+		double time_ms;
+		unsigned long long nodes;
+	};
+	std::vector<std::string> m_solvers;
+	std::vector<std::vector<std::vector<Sample>>> m_samples;	// [solver][move number]
+
+	static void PrintRow(std::ostream& out, const std::string& label, std::vector<Sample>& samples);
+
+public:
+	void Add(const std::string& solver, unsigned int moveNumber, double time_ms, unsigned long long nodes);
+	void Clear(void);
+	bool IsEmpty(void) const;
+	void PrintSummary(std::ostream& out, bool bPerMoveNumber = true) const;
+};
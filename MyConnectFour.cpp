@@ -18,136 +18,303 @@
 #include <iostream>
 #include <stdlib.h>
 #include <ctime>
-#include <chrono>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <atomic>
+#include <new>
 #include "RandomPlay_Solver.h"
 #include "MinimaxPlay_Solver.h"
 #include "MinimaxABPlay_Solver.h"
+#include "Benchmark.h"
+#include "BatchAnalysis.h"
+#include "SolverServer.h"
+#include "Tournament.h"
 
-// Global Variables used in tournament play.  Future work is to move this into a tournament class.
-bool bShowWinner = true;
-bool bShowMoveByMove = true;
-bool bShowMoveHistory = false;
-bool bShowGameNumber = true;
+/// <summary>
+/// BenchMain() runs the position benchmark suites:
+///   MyConnectFour --bench [ab|minimax] [depth] [--json file] [--perf] [--repeat n] [--save-baseline file] [--compare file] [--threshold percent]
+/// The results are displayed as a table and written as JSON (to the file, or to the console).
+/// --perf adds hardware counters (cycles, instructions, cache and branch misses) per node and per move, where the system provides them.
+/// --repeat runs each suite n times and keeps the median time.  --save-baseline stores the results; --compare checks them against a stored baseline
+/// (node counts exactly, times within the threshold, 5% by default, or the noise of the runs).
+/// The exit code is 1 if a score is wrong or the node counts differ from the baseline, 2 if a suite is slower than the baseline, 0 otherwise.
+/// </summary>
+int BenchMain(int argc, char* argv[]) {
+    std::string solver = "ab";
+    unsigned int depth = 0;
+    std::string jsonFile, saveFile, compareFile;
+    bool bPerfCounters = false;
+    unsigned int nRepeats = 1;
+    double threshold = 0.05;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--json") && (i + 1 < argc))
+            jsonFile = argv[++i];
+        else if (arg == "--perf")
+            bPerfCounters = true;
+        else if ((arg == "--repeat") && (i + 1 < argc))
+            nRepeats = (unsigned int)atoi(argv[++i]);
+        else if ((arg == "--save-baseline") && (i + 1 < argc))
+            saveFile = argv[++i];
+        else if ((arg == "--compare") && (i + 1 < argc))
+            compareFile = argv[++i];
+        else if ((arg == "--threshold") && (i + 1 < argc))
+            threshold = atof(argv[++i]) / 100.0;
+        else if (isdigit((unsigned char)arg[0]))
+            depth = (unsigned int)atoi(arg.c_str());
+        else
+            solver = arg;
+    }
+
+    std::vector<BenchSuiteResult> results;
+    bool bCorrect = RunBenchmarkSuites(solver, depth, results, bPerfCounters, nRepeats);
+    if (jsonFile.empty()) {
+        PrintBenchmarkResults(solver, depth, results, std::cout);
+    }
+    else {
+        std::ofstream json(jsonFile);
+        PrintBenchmarkResults(solver, depth, results, json);
+    }
+    if (!bCorrect)
+        return 1;
+
+    if (!saveFile.empty() && !SaveBenchmarkBaseline(saveFile, solver, depth, results))
+        return 1;
+    if (!compareFile.empty())
+        return (int)CompareBenchmarkBaseline(compareFile, solver, depth, results, threshold);
+    return 0;
+}
 
 /// <summary>
-/// PlayTwoSolvers() allows two solvers (both derived from Solver_ConnectFour class) to play each other.  
-/// Fundamentally, each solver is presented with a board and is asked for its best move.  Solvers alternate with each move until the game is won or is drawn.
-/// Solvers do not think while it is the other solvers turn to move.  Future work is to allow solvers to think during the other player's move.
-/// Both solvers are initialized prior to this function call.
+/// PerftMain() runs perft:  MyConnectFour --perft [depth] [threads] [moves]
+/// The exit code is non-zero if a count from the empty board does not match the reference count.
 /// </summary>
-/// <param name="p1">First Solver (to play as RED)</param>
-/// <param name="p2">Second Solver (to play as YELLOW)</param>
-/// <returns></returns>
-int PlayTwoSolvers( Solver_ConnectFour *p1, Solver_ConnectFour *p2) {
-    int winner;
-    Move m;
-    typePlayer playerToMove = RED;  // RED moves first; in this case p1 is RED, P2 is YELLOW
-
-    Board vboard; // the tournament board
-    vboard.InitBoard(playerToMove);
-
-    MoveHistory mh; // the move history
-    mh.ResetHistory();
-
-    // Loop until there is a winner
-    for (; ; ) {
-        
-        // 1. If there are no valid moves on the board, the game is a draw
-        if (vboard.IsNoMove()) {
-            winner = 0;
-            break;
-        }
+int PerftMain(int argc, char* argv[]) {
+    unsigned int depth = (argc > 2) ? (unsigned int)atoi(argv[2]) : 9;
+    unsigned int nThreads = (argc > 3) ? (unsigned int)atoi(argv[3]) : 1;
+    std::string moves = (argc > 4) ? argv[4] : "";
+    return BenchmarkPerft(moves, depth, nThreads) ? 0 : 1;
+}
 
-        // 2. Select a Valid Move and Play it
-        if (playerToMove == RED) {
-            m = p1->SolveBoard(vboard, mh.NumberOfMoves());
-        }
-        else {
-            m = p2->SolveBoard(vboard, mh.NumberOfMoves());
-        }
+//
+// Allocation test
+//
 
-        if (bShowMoveByMove) {
-            std::cout << m << " ";
-        }
+// Calls to operator new since the program started (see AllocTestMain()); counting costs one relaxed atomic increment per allocation
+static std::atomic<unsigned long long> allocations(0);
 
-        vboard.MakeMove(m,playerToMove);
-        mh.AddMove(m);
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc((size == 0) ? 1 : size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept {
+    free(p);
+}
+void operator delete(void* p, std::size_t) noexcept {
+    free(p);
+}
 
+/// <summary>
+/// AllocTestMain() checks that playing a game allocates no memory:  MyConnectFour --alloc-test [games]
+/// Each pairing of solvers (random, minimax, alpha-beta with variety of play, and alpha-beta under a time control) plays one game to warm up, 
+/// then the given number of games (10 by default), counting every call to operator new while they are played.  The games are played as in a 
+/// tournament, without display.  The exit code is 1 if any game allocated.
+/// </summary>
+int AllocTestMain(int argc, char* argv[]) {
+    unsigned int nGames = (argc > 2) ? (unsigned int)atoi(argv[2]) : 10;
+    if (nGames == 0)
+        nGames = 1;
 
-        // 3. Check if the moving player won the game
-        if (vboard.IsWin(playerToMove)) {
-            winner = (playerToMove == RED) ? 1 : -1;
-            break;
-        }
+    RandomPlay_Solver random1, random2;
+    MinimaxPlay_Solver minimax(4, false);
+    MinimaxABPlay_Solver ab(8, true), ab2(6, true), timed(12, false);
+    struct AllocPairing {
+        Solver_ConnectFour* red;
+        Solver_ConnectFour* yellow;
+        double baseSeconds;     // time control (0 = untimed)
+        double incrementSeconds;
+    };
+    const AllocPairing pairings[] = {
+        { &random1, &random2, 0.0, 0.0 },
+        { &minimax, &random1, 0.0, 0.0 },
+        { &ab, &minimax, 0.0, 0.0 },
+        { &ab, &ab2, 0.0, 0.0 },
+        { &timed, &ab2, 0.5, 0.01 },
+        { &timed, &minimax, 0.5, 0.01 },
+    };
+
+    bool bClean = true;
+    std::cout << std::left << std::setw(56) << "Pairing" << std::right << std::setw(12) << "Games" << std::setw(16) << "Allocs/Game" << std::endl;
+    for (const AllocPairing& pairing : pairings) {
+        Tournament tournament;
+        tournament.SetDisplay(false, false, false, false);
+        tournament.SetTimeControl(pairing.baseSeconds, pairing.incrementSeconds);
+        std::string name = pairing.red->GetFingerprint() + " - " + pairing.yellow->GetFingerprint();
+        if (pairing.baseSeconds > 0)
+            name += " (timed)";
+
+        // The first game sets up the solvers' and the tournament's buffers
+        tournament.PlayTwoSolvers(pairing.red, pairing.yellow, std::cout);
+        unsigned long long before = allocations.load();
+        for (unsigned int g = 0; g < nGames; g++)
+            tournament.PlayTwoSolvers(pairing.red, pairing.yellow, std::cout);
+        unsigned long long n = allocations.load() - before;
 
-        // 4. Toggle player for the next move
-        playerToMove = (typePlayer)!playerToMove;
+        std::cout << std::left << std::setw(56) << name << std::right << std::setw(12) << nGames << std::setw(16) << std::fixed 
+            << std::setprecision(1) << (double)n / nGames << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        bClean = bClean && (n == 0);
     }
+    std::cout << (bClean ? "No allocation while playing" : "Games allocated memory") << std::endl;
+    return bClean ? 0 : 1;
+}
 
-    if (bShowWinner) {
-        switch (winner) {
-        case 1:
-            std::cout << " RED WINS! \n";
-            break;
-        case -1:
-            std::cout << " YELLOW WINS! \n";
-            break;
-        default:
-            std::cout << " DRAW! \n";
-            break;
+/// <summary>
+/// MakeSolver() returns a new solver, by name, for the command line modes: "ab" (MinimaxABPlay_Solver), "minimax" (MinimaxPlay_Solver) or 
+/// "random" (RandomPlay_Solver); variety of play is off, so that the answers are reproducible
+/// </summary>
+Solver_ConnectFour* MakeSolver(const std::string& name, unsigned int depth) {
+    if (name == "minimax")
+        return new MinimaxPlay_Solver(depth, false);
+    if (name == "random")
+        return new RandomPlay_Solver();
+    return new MinimaxABPlay_Solver(depth, false);
+}
+
+/// <summary>
+/// AnalyzeMain() finds the best move of every position of a file:
+///   MyConnectFour --analyze [file] [ab|minimax|random] [depth] [--threads n] [--cache n] [--out file]
+/// The positions are read from the file (or the standard input, if there is no file or it is "-"), one per line, and the results are written in 
+/// the same order to the output file (or the standard output); see AnalyzePositions().  The solvers share a root search cache of n searches 
+/// (100000 by default; 0 for none).  The totals are displayed on the standard error.
+/// </summary>
+int AnalyzeMain(int argc, char* argv[]) {
+    std::string inFile = "-", outFile = "-", solver = "ab";
+    unsigned int depth = 12, nThreads = 0;
+    size_t cacheCapacity = 100000;
+    bool bInFile = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--threads") && (i + 1 < argc))
+            nThreads = (unsigned int)atoi(argv[++i]);
+        else if ((arg == "--cache") && (i + 1 < argc))
+            cacheCapacity = (size_t)atoll(argv[++i]);
+        else if ((arg == "--out") && (i + 1 < argc))
+            outFile = argv[++i];
+        else if (isdigit((unsigned char)arg[0]))
+            depth = (unsigned int)atoi(arg.c_str());
+        else if ((arg == "ab") || (arg == "minimax") || (arg == "random"))
+            solver = arg;
+        else if (!bInFile) {
+            inFile = arg;
+            bInFile = true;
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
         }
     }
-    
-    if (bShowMoveHistory)
-        mh.PrintMoveHistory();
 
-    return winner;
+    std::unique_ptr<Solver_ConnectFour> p(MakeSolver(solver, depth));
+    p->EnableSolveCache(cacheCapacity);
+
+    AnalysisSummary summary;
+    if (!AnalyzePositionFile(p.get(), inFile, outFile, nThreads, &summary))
+        return 1;
+    PrintAnalysisSummary(summary, std::cerr);
+    std::shared_ptr<SolveCache> cache = p->GetSolveCache();
+    if (cache)
+        std::cerr << "Search Cache Hits / Misses: " << cache->GetHits() << " / " << cache->GetMisses() << std::endl;
+    return 0;
 }
 
 /// <summary>
-/// MatchPlay () allows two solvers (both derived from Solver_ConnectFour class) to play each other for a specified number of games. 
+/// ServerMain() keeps a solver resident and answers requests (see SolverServer.h):
+///   MyConnectFour --server [ab|minimax|random] [depth] [--socket path] [--threads n] [--clients n] [--cache n]
+///   MyConnectFour --server-bench [ab|minimax|random] [depth] [--socket path] [--threads n] [--clients n] [--requests n] [--cache n]
+/// Without --socket, a single session is served on the standard input and output.  With --socket, any number of clients (up to --clients, 64 by
+/// default) connect to the Unix domain socket; the server runs until it is killed.  --threads sets the number of searches run at the same time 
+/// (one per hardware thread by default) and --cache the capacity of the root search cache shared by all of them (100000 searches by default).
+/// --server-bench starts a server on the socket (/tmp/myconnectfour-bench.sock by default), loads it with --clients clients (8 by default) sending 
+/// --requests requests each (200 by default), and reports the throughput and the latency.
 /// </summary>
-/// <param name="p1">First Solver (to play as RED)</param>
-/// <param name="p2">Second Solver (to play as YELLOW)</param>
-/// <param name="numberOfGames">Number of Games to be Played</param>
-void MatchPlay(Solver_ConnectFour* p1, Solver_ConnectFour* p2, unsigned int numberOfGames = 1) {
-    unsigned long int NumGames = 0, RedWins = 0, YellowWins = 0, Draw = 0;
-    
-    for (unsigned int i = 0; i < numberOfGames; i++) {
-        if (bShowGameNumber)
-            std::cout << "[ " << i << " ] ";
-        int winner = PlayTwoSolvers(p1, p2);
-        NumGames++;
-        switch (winner) {
-        case 1:
-            RedWins++;
-            break;
-        case -1:
-            YellowWins++;
-            break;
-        case 0:
-            Draw++;
-            break;
-        default:
-            break;
+int ServerMain(int argc, char* argv[]) {
+    bool bBenchmark = (std::string(argv[1]) == "--server-bench");
+    std::string solver = "ab", socketPath;
+    unsigned int depth = 12, nThreads = 0, nClients = bBenchmark ? 8 : 64, nRequests = 200;
+    size_t cacheCapacity = 100000;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--socket") && (i + 1 < argc))
+            socketPath = argv[++i];
+        else if ((arg == "--threads") && (i + 1 < argc))
+            nThreads = (unsigned int)atoi(argv[++i]);
+        else if ((arg == "--clients") && (i + 1 < argc))
+            nClients = (unsigned int)atoi(argv[++i]);
+        else if ((arg == "--requests") && (i + 1 < argc))
+            nRequests = (unsigned int)atoi(argv[++i]);
+        else if ((arg == "--cache") && (i + 1 < argc))
+            cacheCapacity = (size_t)atoll(argv[++i]);
+        else if (isdigit((unsigned char)arg[0]))
+            depth = (unsigned int)atoi(arg.c_str());
+        else if ((arg == "ab") || (arg == "minimax") || (arg == "random"))
+            solver = arg;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
         }
     }
 
-    std::cout << std::endl;
-    std::cout << "Number of Games: " << NumGames << std::endl;
-    std::cout << "Number of Red Wins: " << RedWins << std::endl;
-    std::cout << "Number of Yellow Wins: " << YellowWins << std::endl;
-    std::cout << "Number of Draws: " << Draw << std::endl;
+    std::unique_ptr<Solver_ConnectFour> p(MakeSolver(solver, depth));
+    p->EnableSolveCache(cacheCapacity);
+    if (bBenchmark)
+        return BenchmarkServer(*p, socketPath.empty() ? "/tmp/myconnectfour-bench.sock" : socketPath, nThreads, nClients, nRequests) ? 0 : 1;
+
+    SolverServer server(*p, nThreads, nClients);
+    if (socketPath.empty()) {
+        server.ServeStream(std::cin, std::cout);
+        return 0;
+    }
+    std::cerr << "Listening on " << socketPath << std::endl;
+    return server.ServeUnixSocket(socketPath) ? 0 : 1;
 }
 
-int main()
+int main(int argc, char* argv[])
 {
+    if ((argc > 1) && (std::string(argv[1]) == "--bench"))
+        return BenchMain(argc, argv);
+    if ((argc > 1) && (std::string(argv[1]) == "--perft"))
+        return PerftMain(argc, argv);
+    if ((argc > 1) && (std::string(argv[1]) == "--alloc-test"))
+        return AllocTestMain(argc, argv);
+    if ((argc > 1) && (std::string(argv[1]) == "--analyze"))
+        return AnalyzeMain(argc, argv);
+    if ((argc > 1) && ((std::string(argv[1]) == "--server") || (std::string(argv[1]) == "--server-bench")))
+        return ServerMain(argc, argv);
+
+    Tournament tournament;
+
     /* Random Play */
     /*
     RandomPlay_Solver rp_Solver;
     rp_Solver.SelfPlayMatch(3);
     */
 
+    /* Random Playout Benchmark */
+    /*
+    RandomPlay_Solver rpb_Solver;
+    rpb_Solver.SelfPlayMatch(10000000, true);
+    */
+
+    /* IsWin / IsWinBatch micro-benchmark */
+    /*
+    BenchmarkIsWin(1000000);
+    */
+
     /* Minimax Play */
     /*
     MinimaxPlay_Solver mmp_Solver;
@@ -160,6 +327,88 @@ int main()
     mmABp_Solver.SelfPlayMatch(1, 14);
     */
 
+    /* Playing Two Solvers Against Each Other From An Opening Suite (both colours) */
+    /*
+    std::vector<std::string> openings;
+    if (Tournament::LoadOpenings("openings.txt", openings)) {
+        MinimaxABPlay_Solver ab8(8, false), ab6(6, false);
+        tournament.OpeningMatchPlay(&ab8, &ab6, openings);
+    }
+    */
+
+    /* Is one solver stronger than another?  Stop as soon as the SPRT decides */
+    /*
+    MinimaxABPlay_Solver abNew(8, true), abOld(6, true);
+    tournament.SPRTMatchPlay(&abNew, &abOld, SPRT(0.0, 20.0, 0.05, 0.05), 10000);
+    */
+
+    /* Where does the time of a search go?  Trace the searches of a match and open the trace with chrome://tracing */
+    /*
+    MinimaxABPlay_Solver abTraced(12, false), abOpponent(8, false);
+    SearchTrace::Enable();
+    tournament.MatchPlay(&abTraced, &abOpponent, 1);
+    SearchTrace::Disable();
+    SearchTrace::DumpChromeJSON("search_trace.json");
+    */
+
+    /* Playing Two Solvers at Equal Time (10 seconds per game plus 0.1 second per move) rather than at Equal Depth */
+    /*
+    MinimaxABPlay_Solver abDeep(20, false), abShallow(20, true);
+    tournament.SetTimeControl(10.0, 0.1);
+    tournament.MatchPlay(&abDeep, &abShallow, 100);
+    tournament.SetTimeControl(0.0);
+    */
+
+    /* Self-play games for later analysis: every game is written to a compact game record file (about 10 bytes per game) */
+    /*
+    MinimaxABPlay_Solver abRecorded(6, true);
+    tournament.SetDisplay(false, false, false, false);
+    tournament.SetGameRecordFile("selfplay.c4g");
+    tournament.MatchPlay(&abRecorded, &abRecorded, 1000000);
+    tournament.SetGameRecordFile("");
+    */
+
+    /* Scoring a file of positions on all hardware threads (as MyConnectFour --analyze positions.txt ab 12 --out scores.txt) */
+    /*
+    MinimaxABPlay_Solver abAnalysis(12, false);
+    abAnalysis.EnableSolveCache(100000);
+    AnalysisSummary summary;
+    if (AnalyzePositionFile(&abAnalysis, "positions.txt", "scores.txt", 0, &summary))
+        PrintAnalysisSummary(summary, std::cout);
+    */
+
+    /* Searching in the background: at most 2 seconds, cancelled early if the answer is no longer needed; the best move so far is returned */
+    /*
+    MinimaxABPlay_Solver abAsync(20, false);
+    Board asyncBoard;
+    Board::FromMoves("4453", asyncBoard);
+    AsyncSolve search = abAsync.SolveBoardAsync(asyncBoard, 4, std::chrono::steady_clock::now() + std::chrono::seconds(2));
+    // ... search.token.Cancel(); ...
+    SolveResult result = search.result.get();
+    std::cout << "Move " << result.move << (result.bComplete ? "" : " (best so far)") << std::endl;
+    */
+
+    /* Keeping a solver resident: answer solve / analyze requests on a Unix domain socket (as MyConnectFour --server ab 12 --socket /tmp/c4.sock) */
+    /*
+    MinimaxABPlay_Solver abServed(12, false);
+    abServed.EnableSolveCache(100000);
+    SolverServer server(abServed, 0, 64);
+    server.ServeUnixSocket("/tmp/c4.sock");
+    */
+
+    /* Ranking Solver Configurations: round-robin with Elo ratings, results streamed to a CSV file */
+    /*
+    std::vector<std::unique_ptr<Solver_ConnectFour>> pool;
+    for (unsigned int depth = 2; depth <= 8; depth++)
+        pool.emplace_back(new MinimaxABPlay_Solver(depth, true));
+    pool.emplace_back(new RandomPlay_Solver());
+    for (auto& p : pool)
+        tournament.AddSolver(p.get());
+    tournament.SetDisplay(false, false, false, false);
+    tournament.SetResultsFile("tournament.csv", RESULTS_CSV);
+    tournament.RoundRobin(20);
+    */
+
     /* Playing Two Solvers Against Each Other */
     unsigned int nGames = 1000;
     RandomPlay_Solver rp_Solver;
@@ -170,12 +419,12 @@ int main()
     Solver_ConnectFour* p1 = &mmABp_Solver1;
     Solver_ConnectFour* p2 = &mmABp_Solver2;
 
-    MatchPlay(p1, p2, nGames);  
+    tournament.MatchPlay(p1, p2, nGames);  
 
     p1 = &rp_Solver;
     p2 = &mm_Solver;
 
-    MatchPlay(p1, p2, nGames);
+    tournament.MatchPlay(p1, p2, nGames);
     
     /* Forcing user input before ending the program */
     std::string strInput;
@@ -0,0 +1,126 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+/// <summary>
+/// DefaultNumberOfThreads() returns the number of hardware threads (at least 1)
+/// </summary>
+inline unsigned int DefaultNumberOfThreads(void) {
+	unsigned int n = std::thread::hardware_concurrency();
+	return (n == 0) ? 1 : n;
+}
+
+/// <summary>
+/// RunOrdered() runs jobs on a pool of worker threads and hands the results back to the calling thread in job order.
+/// 
+///   next(Job&) -> bool                 fetches the next job (called by one thread at a time); returns false when there are no more jobs
+///   work(worker, Job&) -> Result       does the job on worker thread 'worker' (0 .. nThreads-1); worker-owned state may be indexed by 'worker'
+///   consume(seq, Result&) -> bool      receives the results in job order (seq = 0, 1, 2, ...) on the calling thread; returns false to stop early
+/// 
+/// At most 'window' jobs are in flight (fetched but not yet consumed), so the results waiting to be consumed never take more than 'window' slots,
+/// however many jobs there are.  With one thread, the jobs are run on the calling thread.
+/// </summary>
+template <typename Job, typename Result, typename NextJob, typename DoJob, typename Consume>
+void RunOrdered(unsigned int nThreads, size_t window, NextJob next, DoJob work, Consume consume) {
+	if (nThreads == 0)
+		nThreads = DefaultNumberOfThreads();
+	if (window < nThreads)
+		window = nThreads;
+
+	if (nThreads == 1) {
+		Job job;
+		for (size_t seq = 0; next(job); seq++) {
+			Result r = work(0u, job);
+			if (!consume(seq, r))
+				break;
+		}
+		return;
+	}
+
+	std::mutex mtx;
+	std::condition_variable cvWork, cvDone;
+	std::vector<Result> slots(window);
+	std::vector<char> ready(window, 0);
+	size_t issued = 0, consumed = 0;
+	bool exhausted = false, stop = false;
+
+	auto worker = [&](unsigned int w) {
+		for (; ; ) {
+			Job job;
+			size_t seq;
+			{
+				std::unique_lock<std::mutex> lock(mtx);
+				cvWork.wait(lock, [&] { return stop || exhausted || (issued < consumed + window); });
+				if (stop || exhausted)
+					return;
+				if (!next(job)) {
+					exhausted = true;
+					cvWork.notify_all();
+					cvDone.notify_all();
+					return;
+				}
+				seq = issued++;
+			}
+
+			Result r = work(w, job);
+
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				slots[seq % window] = std::move(r);
+				ready[seq % window] = 1;
+			}
+			cvDone.notify_all();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned int w = 0; w < nThreads; w++) {
+		threads.emplace_back(worker, w);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		for (; ; ) {
+			cvDone.wait(lock, [&] { return ready[consumed % window] || (exhausted && (consumed == issued)); });
+			if (!ready[consumed % window])
+				break;	// all jobs done
+
+			Result r = std::move(slots[consumed % window]);
+			ready[consumed % window] = 0;
+			size_t seq = consumed++;
+			cvWork.notify_all();
+
+			lock.unlock();
+			bool bContinue = consume(seq, r);
+			lock.lock();
+
+			if (!bContinue) {
+				stop = true;
+				cvWork.notify_all();
+				break;
+			}
+		}
+	}
+
+	for (auto& t : threads) {
+		t.join();
+	}
+}
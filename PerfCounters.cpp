@@ -0,0 +1,222 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <iomanip>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include "PerfCounters.h"
+
+#if C4_PERF_COUNTERS
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+static const char* pmuEventNames[PMU_NUMBER_OF_EVENTS] = { "cycles", "instructions", "L1D misses", "LLC misses", "branch misses" };
+
+#if C4_PERF_COUNTERS
+
+/// <summary>
+/// OpenPmuEvent() opens one counter, disabled, counting in user space only; it is inherited by the threads created afterwards (e.g., match workers)
+/// </summary>
+/// <returns>File descriptor, or -1 (errno is set)</returns>
+static int OpenPmuEvent(t_PmuEvent e) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	switch (e) {
+	case PMU_CYCLES:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CPU_CYCLES;
+		break;
+	case PMU_INSTRUCTIONS:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+		break;
+	case PMU_L1D_MISSES:
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		break;
+	case PMU_LLC_MISSES:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		break;
+	default:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+		break;
+	}
+	attr.disabled = 1;
+	attr.inherit = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+#endif
+
+/// <summary>
+/// PerfCounters() opens every counter the system provides; the others are left closed (see GetError())
+/// </summary>
+PerfCounters::PerfCounters(void) {
+	for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+		fd[e] = -1;
+	}
+#if C4_PERF_COUNTERS
+	int err = 0;
+	for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+		fd[e] = OpenPmuEvent((t_PmuEvent)e);
+		if ((fd[e] < 0) && (err == 0))
+			err = errno;
+	}
+	if (!IsAvailable()) {
+		if ((err == EACCES) || (err == EPERM))
+			error = "permission denied (see /proc/sys/kernel/perf_event_paranoid)";
+		else if ((err == ENOENT) || (err == EOPNOTSUPP) || (err == ENODEV))
+			error = "not provided by this CPU or virtual machine";
+		else if (err == ENOSYS)
+			error = "perf_event_open() not supported by this kernel";
+		else
+			error = strerror(err);
+	}
+#else
+	error = "not supported on this platform";
+#endif
+}
+
+PerfCounters::~PerfCounters(void) {
+#if C4_PERF_COUNTERS
+	for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+		if (fd[e] >= 0)
+			close(fd[e]);
+	}
+#endif
+}
+
+/// <summary>
+/// PerfCounters::IsAvailable() returns true if at least one counter could be opened
+/// </summary>
+bool PerfCounters::IsAvailable(void) const {
+	for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+		if (fd[e] >= 0)
+			return true;
+	}
+	return false;
+}
+
+/// <summary>
+/// PerfCounters::GetError() returns why no counter is available (empty if one is)
+/// </summary>
+const std::string& PerfCounters::GetError(void) const {
+	return error;
+}
+
+/// <summary>
+/// PerfCounters::Start() resets the counters to 0 and starts counting
+/// </summary>
+void PerfCounters::Start(void) {
+#if C4_PERF_COUNTERS
+	for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+		if (fd[e] >= 0) {
+			ioctl(fd[e], PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd[e], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+}
+
+/// <summary>
+/// PerfCounters::Stop() stops counting and returns the counts since Start().  When there are more counters than hardware registers, the kernel 
+/// time-shares them; each count is then scaled by (time enabled / time running).
+/// </summary>
+/// <returns>Counts (counters that are not available are not valid)</returns>
+PerfSample PerfCounters::Stop(void) {
+	PerfSample s;
+#if C4_PERF_COUNTERS
+	for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+		if (fd[e] >= 0)
+			ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+	}
+	for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+		uint64_t values[3];	// value, time enabled, time running
+		if ((fd[e] < 0) || (read(fd[e], values, sizeof(values)) != (ssize_t)sizeof(values)) || (values[2] == 0))
+			continue;
+		s.count[e] = (values[2] < values[1]) ? (double)values[0] * ((double)values[1] / (double)values[2]) : (double)values[0];
+		s.bValid[e] = true;
+	}
+#endif
+	return s;
+}
+
+/// <summary>
+/// PerfCounters::EventName() returns the name of a counter
+/// </summary>
+const char* PerfCounters::EventName(t_PmuEvent e) {
+	return ((e >= 0) && (e < PMU_NUMBER_OF_EVENTS)) ? pmuEventNames[e] : "?";
+}
+
+/// <summary>
+/// PerfCounters::PrintReport() displays the counts in total, per node searched and per move played, followed by the instructions per cycle and
+/// the miss rates, e.g.:
+///   Counter                   Total          /node          /move
+///   cycles                 2.81e+09          158.3        4.3e+06
+/// </summary>
+/// <param name="out">Stream to which the report is written</param>
+/// <param name="s">Counts</param>
+/// <param name="nodes">Nodes searched while counting (0 = not known)</param>
+/// <param name="moves">Moves played while counting (0 = not known)</param>
+void PerfCounters::PrintReport(std::ostream& out, const PerfSample& s, double nodes, double moves) {
+	if (s.IsEmpty()) {
+		out << "Hardware counters: not available" << std::endl;
+		return;
+	}
+	std::streamsize precision = out.precision();
+	out << std::left << std::setw(16) << "Counter" << std::right << std::setw(16) << "Total" << std::setw(14) << "/node" << std::setw(14) << "/move" << std::endl;
+	for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+		out << std::left << std::setw(16) << pmuEventNames[e] << std::right;
+		if (!s.bValid[e]) {
+			out << std::setw(16) << "n/a" << std::endl;
+			continue;
+		}
+		out << std::setprecision(4) << std::setw(16) << s.count[e];
+		out << std::setw(14);
+		if (nodes > 0)
+			out << s.count[e] / nodes;
+		else
+			out << "-";
+		out << std::setw(14);
+		if (moves > 0)
+			out << s.count[e] / moves;
+		else
+			out << "-";
+		out << std::endl;
+	}
+	out << std::setprecision(3);
+	if (s.bValid[PMU_CYCLES] && s.bValid[PMU_INSTRUCTIONS] && (s.count[PMU_CYCLES] > 0))
+		out << "Instructions per cycle: " << s.count[PMU_INSTRUCTIONS] / s.count[PMU_CYCLES] << std::endl;
+	if (s.bValid[PMU_INSTRUCTIONS] && (s.count[PMU_INSTRUCTIONS] > 0)) {
+		if (s.bValid[PMU_BRANCH_MISSES])
+			out << "Branch misses per 1000 instructions: " << 1000.0 * s.count[PMU_BRANCH_MISSES] / s.count[PMU_INSTRUCTIONS] << std::endl;
+		if (s.bValid[PMU_L1D_MISSES])
+			out << "L1D misses per 1000 instructions: " << 1000.0 * s.count[PMU_L1D_MISSES] / s.count[PMU_INSTRUCTIONS] << std::endl;
+		if (s.bValid[PMU_LLC_MISSES])
+			out << "LLC misses per 1000 instructions: " << 1000.0 * s.count[PMU_LLC_MISSES] / s.count[PMU_INSTRUCTIONS] << std::endl;
+	}
+	out << std::setprecision(precision);
+}
@@ -0,0 +1,88 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <string>
+#include <iostream>
+
+/*
+
+Hardware performance counters (cycles, instructions, cache and branch misses), read through the Linux perf_event_open() interface.
+They show whether a search is bound by memory (cache misses per node) or by branches (branch misses per node) rather than only how long it takes.
+Counters are optional: on other platforms, or when the kernel, the CPU or a virtual machine does not provide them (or perf_event_paranoid 
+forbids them), every counter is reported as not available and the benchmarks run as before.  Build with C4_PERF_COUNTERS=0 to leave them out.
+
+*/
+
+#ifndef C4_PERF_COUNTERS
+#if defined(__linux__)
+#define C4_PERF_COUNTERS 1
+#else
+#define C4_PERF_COUNTERS 0
+#endif
+#endif
+
+enum t_PmuEvent { PMU_CYCLES = 0, PMU_INSTRUCTIONS, PMU_L1D_MISSES, PMU_LLC_MISSES, PMU_BRANCH_MISSES, PMU_NUMBER_OF_EVENTS };
+
+/// <summary>
+/// PerfSample holds the counts of one measurement (scaled up if the kernel had to multiplex the counters); a counter that could not be
+/// opened, or never ran, is not valid
+/// </summary>
+struct PerfSample {
+	bool bValid[PMU_NUMBER_OF_EVENTS] = {};
+	double count[PMU_NUMBER_OF_EVENTS] = {};
+
+	bool IsEmpty(void) const {
+		for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+			if (bValid[e])
+				return false;
+		}
+		return true;
+	}
+	void Add(const PerfSample& s) {
+		for (int e = 0; e < PMU_NUMBER_OF_EVENTS; e++) {
+			if (s.bValid[e]) {
+				count[e] += s.count[e];
+				bValid[e] = true;
+			}
+		}
+	}
+};
+
+/// <summary>
+/// PerfCounters counts hardware events in user space for the calling thread and for the threads it creates while the counters are open.
+/// Start() resets and starts the counters, Stop() stops them and returns the counts.
+/// </summary>
+class PerfCounters
+{
+private:
+	int fd[PMU_NUMBER_OF_EVENTS];
+	std::string error;	// why no counter could be opened (empty if at least one was)
+
+public:
+	PerfCounters(void);
+	~PerfCounters(void);
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	bool IsAvailable(void) const;
+	const std::string& GetError(void) const;
+	void Start(void);
+	PerfSample Stop(void);
+
+	static const char* EventName(t_PmuEvent e);
+	static void PrintReport(std::ostream& out, const PerfSample& s, double nodes, double moves);
+};
@@ -0,0 +1,403 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <chrono>
+#include <thread>
+#include <functional>
+#include "Playout.h"
+
+/// <summary>
+/// ThreadRandom() returns the random number generator owned by the calling thread.  Each thread gets its own generator, seeded from the
+/// thread id and the clock, so playouts on different threads never share (or lock) any state.
+/// </summary>
+/// <returns>Random number generator of the calling thread</returns>
+FastRandom& ThreadRandom(void) {
+	thread_local FastRandom rng((uint64_t)std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+		(uint64_t)std::chrono::steady_clock::now().time_since_epoch().count());
+	return rng;
+}
+
+/// <summary>
+/// t_PlayoutTables holds, for every 7-bit set of non-full columns, the number of columns in the set and the n-th column of the set.
+/// This replaces a data-dependent bit-clearing loop (which the branch predictor cannot learn) with two table lookups.
+/// </summary>
+struct t_PlayoutTables {
+	unsigned char count[128];
+	unsigned char nth[128][WIDTH];
+
+	t_PlayoutTables(void) {
+		for (unsigned int cols = 0; cols < 128; cols++) {
+			count[cols] = 0;
+			for (unsigned int c = 0; c < WIDTH; c++) {
+				nth[cols][c] = 0;
+				if (cols & (1u << c)) {
+					nth[cols][count[cols]++] = (unsigned char)c;
+				}
+			}
+		}
+	}
+};
+static const t_PlayoutTables PlayoutTables;
+
+/// <summary>
+/// RandomPlayout() plays a complete game from the specified position, both players selecting a random legal column.
+/// The random column is selected directly from the legal-move mask, and only the player who just moved is checked for a win.
+/// </summary>
+/// <param name="current">Pieces of the player to move</param>
+/// <param name="mask">Pieces of both players</param>
+/// <param name="playerToMove">Player to move in this position</param>
+/// <param name="rng">Random number generator (one per thread)</param>
+/// <param name="numberOfMoves">Returns the number of moves played in the playout</param>
+/// <returns>1, if RED wins; -1, if YELLOW wins; 0, if drawn game</returns>
+int RandomPlayout(BitBoard current, BitBoard mask, typePlayer playerToMove, FastRandom& rng, unsigned int& numberOfMoves) {
+	int color = (playerToMove == RED) ? 1 : -1;
+	unsigned int n = 0;
+
+	for (; ; ) {
+		// 1. If there are no legal moves, the game is a draw
+		BitBoard legal = LegalMoves(mask);
+		if (legal == 0) {
+			numberOfMoves = n;
+			return 0;
+		}
+
+		// 2. Select the r-th legal column and drop the piece
+		unsigned int cols = LegalColumns(mask);
+		unsigned int col = PlayoutTables.nth[cols][rng.NextBounded(PlayoutTables.count[cols])];
+		BitBoard m = legal & COLUMN_MASK(col);
+
+		mask |= m;
+		current |= m;
+		n++;
+
+		// 3. Only the moving player can have won
+		if (IsWinBitBoard(current)) {
+			numberOfMoves = n;
+			return color;
+		}
+
+		// 4. The opponent is now the player to move
+		current ^= mask;
+		color = -color;
+	}
+}
+
+/// <summary>
+/// RandomPlayout() plays a complete random game from the specified board configuration
+/// </summary>
+/// <param name="b">Board configuration to play out (not modified)</param>
+/// <param name="rng">Random number generator (one per thread)</param>
+/// <param name="numberOfMoves">Returns the number of moves played in the playout</param>
+/// <returns>1, if RED wins; -1, if YELLOW wins; 0, if drawn game</returns>
+int RandomPlayout(Board b, FastRandom& rng, unsigned int& numberOfMoves) {
+	typePlayer p = b.GetPlayerToMove();
+	return RandomPlayout(b.GetBoard(p), b.GetBoard(RED) | b.GetBoard(YELLOW), p, rng, numberOfMoves);
+}
+
+
+//
+// Batched (SIMD) playouts
+//
+
+/*
+
+Each vector lane holds one game (current and mask, as above).  Every iteration of the main loop plays one move in every active lane:
+  1. the legal-move mask is computed for all lanes; lanes without a legal move are drawn
+  2. a random column is drawn per lane (xoshiro256**, one generator per lane); lanes whose column is full draw again (rejection 
+     sampling keeps the choice uniform over the legal columns) until every lane has a legal move
+  3. the piece is dropped and the four shift directions of IsWin are checked for the moving player in all lanes
+Finished lanes are refilled with the next start position; once no start positions remain, finished lanes are masked off.
+The lane bookkeeping (results, refills) is scalar but only runs when at least one lane finished.
+
+*/
+
+/// <summary>
+/// PlayoutLanes is the scalar bookkeeping shared by the vectorized kernels: which playout each lane is running, and the lane state while it
+/// is being refilled.
+/// </summary>
+template <int LANES>
+struct PlayoutLanes {
+	alignas(64) BitBoard cur[LANES];
+	alignas(64) BitBoard mask[LANES];
+	long long idx[LANES];
+	size_t next = 0;
+
+	const BitBoard* s_current;
+	const BitBoard* s_mask;
+	const typePlayer* s_player;
+	size_t s_n;
+
+	PlayoutLanes(const BitBoard* current, const BitBoard* mask_, const typePlayer* player, size_t n) : s_current(current), s_mask(mask_), s_player(player), s_n(n) {
+		for (int l = 0; l < LANES; l++) {
+			Refill(l);
+		}
+	}
+
+	void Refill(int l) {
+		if (next < s_n) {
+			idx[l] = (long long)next;
+			cur[l] = s_current[next];
+			mask[l] = s_mask[next];
+			next++;
+		}
+		else {
+			idx[l] = -1;
+			cur[l] = 0;
+			mask[l] = 0;
+		}
+	}
+
+	unsigned int ActiveBits(void) {
+		unsigned int a = 0;
+		for (int l = 0; l < LANES; l++) {
+			if (idx[l] >= 0)
+				a |= (1u << l);
+		}
+		return a;
+	}
+
+	void Finish(unsigned int finished, unsigned int wins, int* results, unsigned int* numberOfMoves) {
+		for (int l = 0; l < LANES; l++) {
+			if (finished & (1u << l)) {
+				size_t i = (size_t)idx[l];
+				unsigned int moves = PopCount(mask[l]) - PopCount(s_mask[i]);
+				int color = (s_player[i] == RED) ? 1 : -1;
+				// the k-th move of the playout is made by the player to move when k is odd
+				results[i] = (wins & (1u << l)) ? ((moves & 1) ? color : -color) : 0;
+				if (numberOfMoves != nullptr)
+					numberOfMoves[i] = moves;
+				Refill(l);
+			}
+		}
+	}
+};
+
+#ifdef C4_X86
+
+C4_TARGET_AVX2
+static void RandomPlayoutsAVX2(const BitBoard* current, const BitBoard* mask, const typePlayer* playerToMove, size_t n, FastRandom& rng,
+	int* results, unsigned int* numberOfMoves) {
+	PlayoutLanes<4> lanes(current, mask, playerToMove, n);
+
+	alignas(32) uint64_t seed[4][4];
+	for (int w = 0; w < 4; w++)
+		for (int l = 0; l < 4; l++)
+			seed[w][l] = rng.Next();
+	__m256i s0 = _mm256_load_si256((const __m256i*)seed[0]);
+	__m256i s1 = _mm256_load_si256((const __m256i*)seed[1]);
+	__m256i s2 = _mm256_load_si256((const __m256i*)seed[2]);
+	__m256i s3 = _mm256_load_si256((const __m256i*)seed[3]);
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i bottom = _mm256_set1_epi64x((long long)BOTTOM);
+	const __m256i top = _mm256_set1_epi64x((long long)TOP);
+	const __m256i column = _mm256_set1_epi64x(0x7F);
+	const __m256i seven = _mm256_set1_epi64x(WIDTH);
+
+	__m256i cur = _mm256_load_si256((const __m256i*)lanes.cur);
+	__m256i msk = _mm256_load_si256((const __m256i*)lanes.mask);
+	unsigned int a = lanes.ActiveBits();
+	__m256i active = _mm256_set_epi64x((a & 8) ? -1 : 0, (a & 4) ? -1 : 0, (a & 2) ? -1 : 0, (a & 1) ? -1 : 0);
+
+	while (!_mm256_testz_si256(active, active)) {
+		// 1. legal moves; lanes without a legal move are drawn
+		__m256i legal = _mm256_andnot_si256(top, _mm256_add_epi64(msk, bottom));
+		__m256i noMove = _mm256_cmpeq_epi64(legal, zero);
+		__m256i draws = _mm256_and_si256(active, noMove);
+		__m256i need = _mm256_andnot_si256(noMove, active);
+
+		// 2. random legal column per lane
+		__m256i chosen = zero;
+		while (!_mm256_testz_si256(need, need)) {
+			__m256i x = _mm256_add_epi64(s1, _mm256_slli_epi64(s1, 2));					// s1 * 5
+			x = _mm256_or_si256(_mm256_slli_epi64(x, 7), _mm256_srli_epi64(x, 57));		// rotl(x, 7)
+			__m256i r = _mm256_add_epi64(x, _mm256_slli_epi64(x, 3));					// x * 9
+			__m256i t = _mm256_slli_epi64(s1, 17);
+			s2 = _mm256_xor_si256(s2, s0);
+			s3 = _mm256_xor_si256(s3, s1);
+			s1 = _mm256_xor_si256(s1, s2);
+			s0 = _mm256_xor_si256(s0, s3);
+			s2 = _mm256_xor_si256(s2, t);
+			s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+
+			__m256i col = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(r, 32), seven), 32);
+			__m256i shift = _mm256_sub_epi64(_mm256_slli_epi64(col, 3), col);
+			__m256i cand = _mm256_and_si256(legal, _mm256_sllv_epi64(column, shift));
+			__m256i ok = _mm256_andnot_si256(_mm256_cmpeq_epi64(cand, zero), need);
+			chosen = _mm256_or_si256(chosen, _mm256_and_si256(cand, ok));
+			need = _mm256_andnot_si256(ok, need);
+		}
+
+		// 3. drop the piece and check the moving player for a win
+		msk = _mm256_or_si256(msk, chosen);
+		cur = _mm256_or_si256(cur, chosen);
+
+		__m256i w, m;
+		m = _mm256_and_si256(cur, _mm256_srli_epi64(cur, 1));
+		w = _mm256_and_si256(m, _mm256_srli_epi64(m, 2));
+		m = _mm256_and_si256(cur, _mm256_srli_epi64(cur, 7));
+		w = _mm256_or_si256(w, _mm256_and_si256(m, _mm256_srli_epi64(m, 14)));
+		m = _mm256_and_si256(cur, _mm256_srli_epi64(cur, 6));
+		w = _mm256_or_si256(w, _mm256_and_si256(m, _mm256_srli_epi64(m, 12)));
+		m = _mm256_and_si256(cur, _mm256_srli_epi64(cur, 8));
+		w = _mm256_or_si256(w, _mm256_and_si256(m, _mm256_srli_epi64(m, 16)));
+		__m256i wins = _mm256_andnot_si256(_mm256_cmpeq_epi64(w, zero), active);
+
+		// 4. the opponent is now the player to move
+		cur = _mm256_xor_si256(cur, msk);
+
+		__m256i finished = _mm256_or_si256(draws, wins);
+		if (!_mm256_testz_si256(finished, finished)) {
+			_mm256_store_si256((__m256i*)lanes.cur, cur);
+			_mm256_store_si256((__m256i*)lanes.mask, msk);
+			lanes.Finish((unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(finished)),
+				(unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(wins)), results, numberOfMoves);
+			cur = _mm256_load_si256((const __m256i*)lanes.cur);
+			msk = _mm256_load_si256((const __m256i*)lanes.mask);
+			a = lanes.ActiveBits();
+			active = _mm256_set_epi64x((a & 8) ? -1 : 0, (a & 4) ? -1 : 0, (a & 2) ? -1 : 0, (a & 1) ? -1 : 0);
+		}
+	}
+}
+
+// GCC's AVX-512 intrinsics start from an undefined vector (e.g., _mm512_undefined_epi32()), which -Wmaybe-uninitialized reports as used
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+C4_TARGET_AVX512
+static void RandomPlayoutsAVX512(const BitBoard* current, const BitBoard* mask, const typePlayer* playerToMove, size_t n, FastRandom& rng,
+	int* results, unsigned int* numberOfMoves) {
+	PlayoutLanes<8> lanes(current, mask, playerToMove, n);
+
+	alignas(64) uint64_t seed[4][8];
+	for (int w = 0; w < 4; w++)
+		for (int l = 0; l < 8; l++)
+			seed[w][l] = rng.Next();
+	__m512i s0 = _mm512_load_si512(seed[0]);
+	__m512i s1 = _mm512_load_si512(seed[1]);
+	__m512i s2 = _mm512_load_si512(seed[2]);
+	__m512i s3 = _mm512_load_si512(seed[3]);
+
+	const __m512i zero = _mm512_setzero_si512();
+	const __m512i bottom = _mm512_set1_epi64((long long)BOTTOM);
+	const __m512i top = _mm512_set1_epi64((long long)TOP);
+	const __m512i column = _mm512_set1_epi64(0x7F);
+	const __m512i seven = _mm512_set1_epi64(WIDTH);
+
+	__m512i cur = _mm512_load_si512(lanes.cur);
+	__m512i msk = _mm512_load_si512(lanes.mask);
+	__mmask8 active = (__mmask8)lanes.ActiveBits();
+
+	while (active) {
+		// 1. legal moves; lanes without a legal move are drawn
+		__m512i legal = _mm512_andnot_si512(top, _mm512_add_epi64(msk, bottom));
+		__mmask8 hasMove = _mm512_test_epi64_mask(legal, legal);
+		__mmask8 draws = active & ~hasMove;
+		__mmask8 need = active & hasMove;
+
+		// 2. random legal column per lane
+		__m512i chosen = zero;
+		while (need) {
+			__m512i x = _mm512_rol_epi64(_mm512_add_epi64(s1, _mm512_slli_epi64(s1, 2)), 7);
+			__m512i r = _mm512_add_epi64(x, _mm512_slli_epi64(x, 3));
+			__m512i t = _mm512_slli_epi64(s1, 17);
+			s2 = _mm512_xor_si512(s2, s0);
+			s3 = _mm512_xor_si512(s3, s1);
+			s1 = _mm512_xor_si512(s1, s2);
+			s0 = _mm512_xor_si512(s0, s3);
+			s2 = _mm512_xor_si512(s2, t);
+			s3 = _mm512_rol_epi64(s3, 45);
+
+			__m512i col = _mm512_srli_epi64(_mm512_mul_epu32(_mm512_srli_epi64(r, 32), seven), 32);
+			__m512i shift = _mm512_sub_epi64(_mm512_slli_epi64(col, 3), col);
+			__m512i cand = _mm512_and_si512(legal, _mm512_sllv_epi64(column, shift));
+			__mmask8 ok = _mm512_mask_test_epi64_mask(need, cand, cand);
+			chosen = _mm512_mask_mov_epi64(chosen, ok, cand);
+			need &= ~ok;
+		}
+
+		// 3. drop the piece and check the moving player for a win
+		msk = _mm512_or_si512(msk, chosen);
+		cur = _mm512_or_si512(cur, chosen);
+
+		__m512i w, m;
+		m = _mm512_and_si512(cur, _mm512_srli_epi64(cur, 1));
+		w = _mm512_and_si512(m, _mm512_srli_epi64(m, 2));
+		m = _mm512_and_si512(cur, _mm512_srli_epi64(cur, 7));
+		w = _mm512_or_si512(w, _mm512_and_si512(m, _mm512_srli_epi64(m, 14)));
+		m = _mm512_and_si512(cur, _mm512_srli_epi64(cur, 6));
+		w = _mm512_or_si512(w, _mm512_and_si512(m, _mm512_srli_epi64(m, 12)));
+		m = _mm512_and_si512(cur, _mm512_srli_epi64(cur, 8));
+		w = _mm512_or_si512(w, _mm512_and_si512(m, _mm512_srli_epi64(m, 16)));
+		__mmask8 wins = _mm512_mask_test_epi64_mask(active, w, w);
+
+		// 4. the opponent is now the player to move
+		cur = _mm512_xor_si512(cur, msk);
+
+		__mmask8 finished = draws | wins;
+		if (finished) {
+			_mm512_store_si512(lanes.cur, cur);
+			_mm512_store_si512(lanes.mask, msk);
+			lanes.Finish(finished, wins, results, numberOfMoves);
+			cur = _mm512_load_si512(lanes.cur);
+			msk = _mm512_load_si512(lanes.mask);
+			active = (__mmask8)lanes.ActiveBits();
+		}
+	}
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+/// <summary>
+/// RandomPlayouts() plays n independent random games, one from each of the specified start positions, and returns the result of each.
+/// The widest instruction set supported by the CPU is used unless a level is requested; the scalar kernel is the fallback.
+/// Intended for SelfPlayMatch() benchmarks and for batches of rollouts (e.g., the leaves of a tree search).
+/// </summary>
+/// <param name="current">Pieces of the player to move, per start position</param>
+/// <param name="mask">Pieces of both players, per start position</param>
+/// <param name="playerToMove">Player to move, per start position</param>
+/// <param name="n">Number of playouts</param>
+/// <param name="rng">Random number generator (the vectorized kernels seed their lanes from it)</param>
+/// <param name="results">Returns 1, if RED wins; -1, if YELLOW wins; 0, if drawn game; per playout</param>
+/// <param name="numberOfMoves">Returns the number of moves played, per playout (may be nullptr)</param>
+/// <param name="level">Instruction set to use (SIMD_AUTO for runtime dispatch)</param>
+void RandomPlayouts(const BitBoard* current, const BitBoard* mask, const typePlayer* playerToMove, size_t n, FastRandom& rng,
+	int* results, unsigned int* numberOfMoves, t_SimdLevel level) {
+	switch (ResolveSimdLevel(level)) {
+#ifdef C4_X86
+	case SIMD_AVX512:
+		RandomPlayoutsAVX512(current, mask, playerToMove, n, rng, results, numberOfMoves);
+		return;
+	case SIMD_AVX2:
+		RandomPlayoutsAVX2(current, mask, playerToMove, n, rng, results, numberOfMoves);
+		return;
+#endif
+	default:
+		for (size_t i = 0; i < n; i++) {
+			unsigned int moves;
+			results[i] = RandomPlayout(current[i], mask[i], playerToMove[i], rng, moves);
+			if (numberOfMoves != nullptr)
+				numberOfMoves[i] = moves;
+		}
+		return;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include "Board.h"
+#include "FastRandom.h"
+#include "CpuFeatures.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/*
+
+The playout kernel does not use the Board class.  A position is described by two bitboards (same layout as Board):
+  current: the pieces of the player to move
+  mask:    the pieces of both players
+The next free square of every column is (mask + BOTTOM); a column is full when that square lands on TOP.
+
+*/
+
+/// <summary>
+/// PopCount() returns the number of bits set in a bitboard
+/// </summary>
+inline unsigned int PopCount(BitBoard x) {
+#ifdef _MSC_VER
+	return (unsigned int)__popcnt64(x);
+#else
+	return (unsigned int)__builtin_popcountll(x);
+#endif
+}
+
+/// <summary>
+/// LegalMoves() returns a bitboard with the next free square of every column that is not full
+/// </summary>
+inline BitBoard LegalMoves(BitBoard mask) {
+	return (mask + BOTTOM) & ~TOP;
+}
+
+#define COLUMN_MASK(col) (0x7FULL << (7 * (col)))
+
+/// <summary>
+/// LegalColumns() returns a 7-bit set of the columns that are not full (bit c is column c+1).  The multiply gathers the row-5 square
+/// of every column (bits 5, 12, ..., 47) into bits 42 thru 48; no two partial products overlap, so there are no carries.
+/// </summary>
+inline unsigned int LegalColumns(BitBoard mask) {
+	BitBoard open = (~mask & (BOTTOM << (HEIGHT - 1))) >> (HEIGHT - 1);
+	return (unsigned int)((open * 0x41041041040ULL) >> 42) & 0x7F;
+}
+
+FastRandom& ThreadRandom(void);
+
+int RandomPlayout(BitBoard current, BitBoard mask, typePlayer playerToMove, FastRandom& rng, unsigned int& numberOfMoves);
+int RandomPlayout(Board b, FastRandom& rng, unsigned int& numberOfMoves);
+
+// Batched playouts: n independent games, advanced 4 (AVX2) or 8 (AVX-512) at a time in vector registers
+void RandomPlayouts(const BitBoard* current, const BitBoard* mask, const typePlayer* playerToMove, size_t n, FastRandom& rng,
+	int* results, unsigned int* numberOfMoves, t_SimdLevel level = SIMD_AUTO);
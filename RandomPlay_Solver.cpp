@@ -18,8 +18,12 @@
 //#include <stdlib.h>
 #include <ctime>
 #include <chrono>
+#include <algorithm>
+#include <vector>
 #include "Solver_ConnectFour.h"
 #include "RandomPlay_Solver.h"
+#include "Playout.h"
+#include "PerfCounters.h"
 
 unsigned long long int iTotalNumberOfMoves;
 
@@ -28,11 +32,12 @@ unsigned long long int iTotalNumberOfMoves;
 //
 
 /// <summary>
-/// RandomPlay_Solver() initializes the randomizer, the board configuration, and the move history associated with the board
+/// RandomPlay_Solver() initializes the randomizer, the board configuration, and the move history associated with the board.
+/// The randomizer is seeded from the clock; MatchPlay() reseeds it for every game (see Solver_ConnectFour::SeedRandom()).
 /// </summary>
 /// <param name=""></param>
 RandomPlay_Solver::RandomPlay_Solver(void) : Solver_ConnectFour () {
-    srand((unsigned int)time(NULL)); // initialize randomizer
+    s_rng.Seed((uint64_t)std::chrono::steady_clock::now().time_since_epoch().count()); // initialize randomizer
     s_board.InitBoard();
     s_mh.ResetHistory();
     iTotalNumberOfMoves = 0;
@@ -52,8 +57,7 @@ RandomPlay_Solver::RandomPlay_Solver(void) : Solver_ConnectFour () {
 /// </summary>
 /// <returns>Best Move</returns>
 Move RandomPlay_Solver::GetBestMove(void) {
-    std::vector<Move> ValidMoves;
-    Move bestMove = 0;
+    typeMoveList ValidMoves;    // no memory allocation
 
     // Find all Valid Moves 
     for (auto const& v : s_board.MoveSequence) {
@@ -64,7 +68,7 @@ Move RandomPlay_Solver::GetBestMove(void) {
 
     // return a random move
     if (ValidMoves.size() != 0) {
-        return ValidMoves.at(rand() % ValidMoves.size());
+        return ValidMoves[s_rng.NextBounded((unsigned int)ValidMoves.size())];
     }
     else {
         return (Move)0;
@@ -88,6 +92,16 @@ Move RandomPlay_Solver::SolveBoard(const Board & b, unsigned int MoveNumber) {
     return GetBestMove(); // return the best move
 }
 
+/// <summary>
+/// RandomPlay_Solver::Clone() returns a new solver with the same configuration, so that games can be played concurrently (one solver per thread).
+/// The caller owns (and deletes) the returned solver.
+/// </summary>
+/// <param name=""></param>
+/// <returns>Copy of this solver</returns>
+Solver_ConnectFour* RandomPlay_Solver::Clone(void) const {
+    return new RandomPlay_Solver(*this);
+}
+
 //
 // Self-Play Methods
 //
@@ -169,9 +183,16 @@ int RandomPlay_Solver::SelfPlay(typePlayer playerToMove) {
 
 /// <summary>
 /// RandomPlay_Solver::RandomMatch() plays a number of games between two players who both randomly select moves.  Used for debugging purposes.
+/// In benchmark mode, the games are played by the bitboard playout kernel (see Playout.h) and the throughput is reported.
 /// </summary>
 /// <param name="nRuns">Number of Games to be played</param>
-void RandomPlay_Solver::SelfPlayMatch(unsigned int nRuns) {
+/// <param name="bBenchmark">Use the playout kernel and report playouts per second</param>
+void RandomPlay_Solver::SelfPlayMatch(unsigned int nRuns, bool bBenchmark) {
+    if (bBenchmark) {
+        PlayoutBenchmark(nRuns);
+        return;
+    }
+
     std::cout << "Playing " << nRuns << " Random Matches\n";
 
     int winner; // result of each game
@@ -184,8 +205,12 @@ void RandomPlay_Solver::SelfPlayMatch(unsigned int nRuns) {
     bShowMoveByMove = false;
     bShowWinner = false;
 
+    // Count hardware events (if the system provides them) along with the time
+    PerfCounters counters;
+
     // Start the clock
     auto c_start_ms = std::chrono::steady_clock().now();
+    counters.Start();
 
     // Play game nRuns times...
     for (unsigned int i = 0; i < nRuns; i++) {
@@ -214,6 +239,7 @@ void RandomPlay_Solver::SelfPlayMatch(unsigned int nRuns) {
     }
 
     // Stop the clock and calculate duration
+    PerfSample perf = counters.Stop();
     auto c_end_ms = std::chrono::steady_clock().now();
     std::chrono::milliseconds duration_ms = (std::chrono::duration_cast<std::chrono::milliseconds>)(c_end_ms - c_start_ms);
 
@@ -232,4 +258,83 @@ void RandomPlay_Solver::SelfPlayMatch(unsigned int nRuns) {
     std::cout << " Total Number Of Yellow Wins : " << yellowW << " [" << yellowP << "]\n";
     std::cout << " Total Number Of Draws : " << iTotalGames - (yellowW + redW) << " [" << drawP << "]\n";
 
+    // Hardware counters per node searched and per move played
+    if (counters.IsAvailable())
+        PerfCounters::PrintReport(std::cout, perf, 0.0, (double)iTotalNumberOfMoves);
+    else
+        std::cout << " Hardware counters not available: " << counters.GetError() << "\n";
+
+}
+
+/// <summary>
+/// RandomPlay_Solver::PlayoutBenchmark() plays a number of random games from the empty board using the batched playout kernel (no Board, no move 
+/// history, no console output per game) and reports the number of playouts and moves per second.  The instruction set is selected at run time.
+/// </summary>
+/// <param name="nRuns">Number of playouts</param>
+void RandomPlay_Solver::PlayoutBenchmark(unsigned int nRuns) {
+    const size_t BATCH = 4096;
+    std::vector<BitBoard> current(BATCH), mask(BATCH);
+    std::vector<typePlayer> players(BATCH);
+    std::vector<int> results(BATCH);
+    std::vector<unsigned int> moves(BATCH);
+
+    std::cout << "Benchmarking " << nRuns << " Random Playouts (" << SimdLevelName(ResolveSimdLevel(SIMD_AUTO)) << ")\n";
+
+    // every playout starts from the empty board with RED to move
+    for (size_t i = 0; i < BATCH; i++) {
+        current[i] = 0;
+        mask[i] = 0;
+        players[i] = RED;
+    }
+
+    FastRandom& rng = ThreadRandom();
+    unsigned int redW = 0, yellowW = 0;
+    iTotalNumberOfMoves = 0;
+
+    PerfCounters counters;
+
+    // Start the clock
+    auto c_start = std::chrono::steady_clock().now();
+    counters.Start();
+
+    for (unsigned int done = 0; done < nRuns; ) {
+        size_t n = std::min((size_t)(nRuns - done), BATCH);
+        RandomPlayouts(current.data(), mask.data(), players.data(), n, rng, results.data(), moves.data());
+
+        for (size_t i = 0; i < n; i++) {
+            switch (results[i]) {
+            case -1:
+                yellowW++;
+                break;
+            case 1:
+                redW++;
+                break;
+            default:
+                break;
+            }
+            iTotalNumberOfMoves += moves[i];
+        }
+        done += (unsigned int)n;
+    }
+
+    // Stop the clock and calculate duration
+    PerfSample perf = counters.Stop();
+    auto c_end = std::chrono::steady_clock().now();
+    double seconds = std::chrono::duration<double>(c_end - c_start).count();
+
+    // Display statistics
+    std::cout << " Total Number Of Playouts : " << nRuns << "\n";
+    std::cout << " Total Number Of Moves : " << iTotalNumberOfMoves << "\n";
+    std::cout << " Total Duration (msec): " << seconds * 1000.0 << "msec\n";
+    std::cout << "Playouts Per sec: " << (double)nRuns / seconds << "\n";
+    std::cout << "Moves Per sec: " << (double)iTotalNumberOfMoves / seconds << "\n";
+    std::cout << " Total Number Of Red Wins : " << redW << " [" << (double)redW / nRuns * 100.0 << "]\n";
+    std::cout << " Total Number Of Yellow Wins : " << yellowW << " [" << (double)yellowW / nRuns * 100.0 << "]\n";
+    std::cout << " Total Number Of Draws : " << nRuns - (yellowW + redW) << " [" << (double)(nRuns - (yellowW + redW)) / nRuns * 100.0 << "]\n";
+
+    // Hardware counters per move played (a playout searches no nodes)
+    if (counters.IsAvailable())
+        PerfCounters::PrintReport(std::cout, perf, 0.0, (double)iTotalNumberOfMoves);
+    else
+        std::cout << " Hardware counters not available: " << counters.GetError() << "\n";
 }
\ No newline at end of file
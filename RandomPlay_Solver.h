@@ -29,14 +29,17 @@ private:
 	bool bShowWinner = false;
 
 	Move GetBestMove(void);
+	void PlayoutBenchmark(unsigned int nRuns);
 
 public:
 	RandomPlay_Solver(void);
 
+	using Solver_ConnectFour::SolveBoard;
 	Move SolveBoard(const Board& b, unsigned int MoveNumber);
+	Solver_ConnectFour* Clone(void) const;
 
 	int SelfPlay(typePlayer playerToMove);
-	void SelfPlayMatch(unsigned int nRuns);
+	void SelfPlayMatch(unsigned int nRuns, bool bBenchmark = false);
 
 	
 };
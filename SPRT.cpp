@@ -0,0 +1,114 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cmath>
+#include "SPRT.h"
+
+/// <summary>
+/// SPRT() sets up the test
+/// </summary>
+/// <param name="elo0">Elo difference under H0</param>
+/// <param name="elo1">Elo difference under H1 (elo1 > elo0)</param>
+/// <param name="alpha">Probability of accepting H1 when H0 is true</param>
+/// <param name="beta">Probability of accepting H0 when H1 is true</param>
+SPRT::SPRT(double elo0, double elo1, double alpha, double beta) {
+	s_elo0 = elo0;
+	s_elo1 = elo1;
+	s_lower = std::log(beta / (1.0 - alpha));
+	s_upper = std::log((1.0 - beta) / alpha);
+	wins = draws = losses = 0;
+}
+
+/// <summary>
+/// SPRT::ExpectedScore() returns the expected score (0 thru 1) of a player that is elo points stronger than the opponent (logistic model)
+/// </summary>
+double SPRT::ExpectedScore(double elo) {
+	return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+/// <summary>
+/// SPRT::AddResult() adds the result of a game and records the new LLR
+/// </summary>
+/// <param name="result">1 = win, 0 = draw, -1 = loss (from the first solver's point of view)</param>
+/// <returns>Status of the test after this game</returns>
+t_SPRTStatus SPRT::AddResult(int result) {
+	if (result > 0)
+		wins++;
+	else if (result < 0)
+		losses++;
+	else
+		draws++;
+	trajectory.push_back(LLR());
+	return Status();
+}
+
+/// <summary>
+/// SPRT::LLR() returns the log-likelihood ratio of H1 against H0 for the results so far.
+/// The mean and variance are estimated with half a game of each kind added, so that one-sided results (e.g., all wins) still have a variance.
+/// </summary>
+double SPRT::LLR(void) const {
+	double n = (double)wins + draws + losses;
+	if (n == 0)
+		return 0.0;
+
+	double w = wins + 0.5, d = draws + 0.5, l = losses + 0.5;
+	double total = w + d + l;
+	double mean = (w + 0.5 * d) / total;
+	double variance = (w * (1.0 - mean) * (1.0 - mean) + d * (0.5 - mean) * (0.5 - mean) + l * mean * mean) / total;
+
+	double s0 = ExpectedScore(s_elo0);
+	double s1 = ExpectedScore(s_elo1);
+	return n * (s1 - s0) * (2.0 * mean - s0 - s1) / (2.0 * variance);
+}
+
+/// <summary>
+/// SPRT::Status() returns SPRT_ACCEPT_H1 / SPRT_ACCEPT_H0 once the LLR has crossed the upper / lower bound, SPRT_CONTINUE otherwise
+/// </summary>
+t_SPRTStatus SPRT::Status(void) const {
+	double llr = LLR();
+	if (llr >= s_upper)
+		return SPRT_ACCEPT_H1;
+	if (llr <= s_lower)
+		return SPRT_ACCEPT_H0;
+	return SPRT_CONTINUE;
+}
+
+double SPRT::GetLowerBound(void) const {
+	return s_lower;
+}
+
+double SPRT::GetUpperBound(void) const {
+	return s_upper;
+}
+
+unsigned int SPRT::NumberOfGames(void) const {
+	return wins + draws + losses;
+}
+
+const std::vector<double>& SPRT::GetTrajectory(void) const {
+	return trajectory;
+}
+
+const char* SPRT::StatusName(t_SPRTStatus status) {
+	switch (status) {
+	case SPRT_ACCEPT_H0:
+		return "H0 accepted";
+	case SPRT_ACCEPT_H1:
+		return "H1 accepted";
+	default:
+		return "inconclusive";
+	}
+}
@@ -0,0 +1,52 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <vector>
+
+enum t_SPRTStatus { SPRT_CONTINUE = 0, SPRT_ACCEPT_H0 = 1, SPRT_ACCEPT_H1 = 2 };
+
+/// <summary>
+/// SPRT is a sequential probability ratio test for solver-vs-solver matches.  It tests H0: the Elo difference is elo0, against H1: the Elo
+/// difference is elo1, with false positive rate alpha and false negative rate beta.  After each result, the log-likelihood ratio (LLR) is compared
+/// with the bounds log(beta / (1 - alpha)) and log((1 - beta) / alpha); the match can stop as soon as one bound is crossed.
+/// The LLR uses the generalized SPRT approximation for win / draw / loss results (as used by Fishtest): 
+///   LLR = N (s1 - s0) (2 mean - s0 - s1) / (2 variance), where s0, s1 are the expected scores under H0, H1.
+/// Reference: https://www.chessprogramming.org/Sequential_Probability_Ratio_Test
+/// </summary>
+class SPRT
+{
+private:
+	double s_elo0, s_elo1;
+	double s_lower, s_upper;
+	unsigned int wins, draws, losses;
+	std::vector<double> trajectory;	// LLR after each result
+
+	static double ExpectedScore(double elo);
+
+public:
+	SPRT(double elo0 = 0.0, double elo1 = 10.0, double alpha = 0.05, double beta = 0.05);
+
+	t_SPRTStatus AddResult(int result);	// 1 = win, 0 = draw, -1 = loss (from the first solver's point of view)
+	double LLR(void) const;
+	t_SPRTStatus Status(void) const;
+
+	double GetLowerBound(void) const;
+	double GetUpperBound(void) const;
+	unsigned int NumberOfGames(void) const;
+	const std::vector<double>& GetTrajectory(void) const;
+	static const char* StatusName(t_SPRTStatus status);
+};
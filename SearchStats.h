@@ -0,0 +1,92 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <cmath>
+
+// Search statistics are counted when C4_SEARCH_STATS is 1 (the default).  Build with C4_SEARCH_STATS=0 to compile the counters out of the 
+// search entirely; GetLastSearchStats() then returns zeros.
+#ifndef C4_SEARCH_STATS
+#define C4_SEARCH_STATS 1
+#endif
+
+/// <summary>
+/// SearchStats describes the last search of a solver (one call of SolveBoard())
+/// </summary>
+struct SearchStats {
+	unsigned long long nodes = 0;				// positions visited (moves made), not counting the root
+	unsigned long long leafEvaluations = 0;		// positions evaluated without searching further (won, drawn, or at the maximum depth)
+	unsigned long long betaCutoffs = 0;			// alpha-beta cutoffs
+	unsigned long long firstMoveCutoffs = 0;	// cutoffs caused by the first move searched (a measure of move ordering)
+	unsigned long long cacheProbes = 0;			// root search cache lookups
+	unsigned long long cacheHits = 0;
+	unsigned int maxDepth = 0;					// deepest ply reached
+	double time_ms = 0.0;
+
+	/// <summary>
+	/// FirstMoveCutoffRate() returns the fraction of cutoffs caused by the first move searched (0 if there were no cutoffs)
+	/// </summary>
+	double FirstMoveCutoffRate(void) const {
+		return (betaCutoffs == 0) ? 0.0 : (double)firstMoveCutoffs / (double)betaCutoffs;
+	}
+
+	/// <summary>
+	/// EffectiveBranchingFactor() returns b such that b^maxDepth = nodes, i.e., the number of moves searched per position on average
+	/// </summary>
+	double EffectiveBranchingFactor(void) const {
+		return ((maxDepth == 0) || (nodes == 0)) ? 0.0 : std::pow((double)nodes, 1.0 / maxDepth);
+	}
+};
+
+/// <summary>
+/// SearchCounters is the policy used by the solvers to count their search statistics.  SearchCounters<true> counts; SearchCounters<false>
+/// has empty inline methods, so the calls in the search compile to nothing.
+/// </summary>
+template <bool bEnabled>
+struct SearchCounters {
+	SearchStats stats;
+
+	inline void Reset(void) { stats = SearchStats(); }
+	inline void Node(unsigned int ply) {
+		stats.nodes++;
+		if (ply > stats.maxDepth)
+			stats.maxDepth = ply;
+	}
+	inline void Leaf(void) { stats.leafEvaluations++; }
+	inline void Cutoff(bool bFirstMove) {
+		stats.betaCutoffs++;
+		if (bFirstMove)
+			stats.firstMoveCutoffs++;
+	}
+	inline void CacheProbe(bool bHit) {
+		stats.cacheProbes++;
+		if (bHit)
+			stats.cacheHits++;
+	}
+};
+
+template <>
+struct SearchCounters<false> {
+	SearchStats stats;
+
+	inline void Reset(void) {}
+	inline void Node(unsigned int) {}
+	inline void Leaf(void) {}
+	inline void Cutoff(bool) {}
+	inline void CacheProbe(bool) {}
+};
+
+typedef SearchCounters<C4_SEARCH_STATS != 0> t_SearchCounters;
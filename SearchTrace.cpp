@@ -0,0 +1,176 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include "SearchTrace.h"
+
+std::atomic<bool> SearchTrace::t_bEnabled(false);
+unsigned int SearchTrace::t_sampleEvery = 1024;
+
+// Registry of the per-thread buffers.  The mutex is only taken when a thread records its first event, and by Enable(), Clear() and the dumps.
+static std::mutex traceMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> traceBuffers;
+static size_t traceCapacity = (size_t)1 << 18;
+static std::chrono::steady_clock::time_point traceEpoch;
+
+static const char* traceEventNames[TRACE_NUMBER_OF_EVENTS] = { "solve", "iteration", "root move", "node" };
+
+/// <summary>
+/// SearchTrace::Enable() starts recording
+/// </summary>
+/// <param name="capacityPerThread">Number of events kept per thread (16 bytes each)</param>
+/// <param name="sampleEvery">One node in sampleEvery is recorded (0 = no node events)</param>
+void SearchTrace::Enable(size_t capacityPerThread, unsigned int sampleEvery) {
+	std::lock_guard<std::mutex> lock(traceMutex);
+	traceCapacity = (capacityPerThread == 0) ? 1 : capacityPerThread;
+	for (auto& b : traceBuffers) {
+		b->records.assign(traceCapacity, TraceRecord());
+		b->head.store(0, std::memory_order_relaxed);
+	}
+	t_sampleEvery = sampleEvery;
+	traceEpoch = std::chrono::steady_clock::now();
+	t_bEnabled.store(true, std::memory_order_release);
+}
+
+/// <summary>
+/// SearchTrace::Disable() stops recording; the events recorded so far are kept until Clear() or Enable()
+/// </summary>
+void SearchTrace::Disable(void) {
+	t_bEnabled.store(false, std::memory_order_release);
+}
+
+/// <summary>
+/// SearchTrace::Clear() discards the events recorded so far
+/// </summary>
+void SearchTrace::Clear(void) {
+	std::lock_guard<std::mutex> lock(traceMutex);
+	for (auto& b : traceBuffers)
+		b->head.store(0, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// SearchTrace::ThreadBuffer() returns the buffer of the calling thread, creating it on the thread's first event
+/// </summary>
+TraceBuffer* SearchTrace::ThreadBuffer(void) {
+	thread_local TraceBuffer* buffer = nullptr;
+	if (buffer == nullptr) {
+		std::lock_guard<std::mutex> lock(traceMutex);
+		traceBuffers.emplace_back(new TraceBuffer());
+		buffer = traceBuffers.back().get();
+		buffer->tid = (unsigned int)traceBuffers.size() - 1;
+		buffer->records.assign(traceCapacity, TraceRecord());
+	}
+	return buffer;
+}
+
+/// <summary>
+/// SearchTrace::Record() appends an event to the calling thread's ring buffer (if tracing is enabled)
+/// </summary>
+void SearchTrace::Record(t_TraceEvent event, uint8_t phase, int32_t arg) {
+	if (!IsEnabled())
+		return;
+	TraceBuffer* b = ThreadBuffer();
+	uint64_t head = b->head.load(std::memory_order_relaxed);
+	TraceRecord& r = b->records[head % b->records.size()];
+	r.ts_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch).count();
+	r.event = (uint16_t)event;
+	r.phase = phase;
+	r.reserved = 0;
+	r.arg = arg;
+	b->head.store(head + 1, std::memory_order_release);
+}
+
+/// <summary>
+/// SearchTrace::EventName() returns the name of an event, as shown in the trace viewer
+/// </summary>
+const char* SearchTrace::EventName(t_TraceEvent event) {
+	return ((unsigned int)event < TRACE_NUMBER_OF_EVENTS) ? traceEventNames[event] : "?";
+}
+
+/// <summary>
+/// SearchTrace::DumpChromeJSON() writes the recorded events in the Chrome trace_event format (one "thread" per search thread)
+/// </summary>
+/// <param name="filename">Output file</param>
+/// <returns>true if the file was written</returns>
+bool SearchTrace::DumpChromeJSON(const std::string& filename) {
+	std::ofstream out(filename);
+	if (!out) {
+		std::cout << "Cannot write trace " << filename << std::endl;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(traceMutex);
+	out << "{\"traceEvents\":[";
+	bool bFirst = true;
+	char ts[32];
+	for (auto& b : traceBuffers) {
+		uint64_t head = b->head.load(std::memory_order_acquire);
+		uint64_t size = b->records.size();
+		for (uint64_t i = (head > size) ? head - size : 0; i < head; i++) {
+			const TraceRecord& r = b->records[i % size];
+			snprintf(ts, sizeof(ts), "%.3f", r.ts_ns / 1000.0);	// microseconds
+			out << (bFirst ? "\n" : ",\n") << "{\"name\":\"" << EventName((t_TraceEvent)r.event) << "\",\"ph\":\"" << (char)r.phase << "\",\"ts\":" << ts
+				<< ",\"pid\":1,\"tid\":" << b->tid;
+			if (r.phase == 'i')
+				out << ",\"s\":\"t\"";
+			out << ",\"args\":{\"arg\":" << r.arg << "}}";
+			bFirst = false;
+		}
+	}
+	out << "\n]}\n";
+	return (bool)out;
+}
+
+/// <summary>
+/// SearchTrace::DumpBinary() writes the recorded events in the compact binary format (see SearchTrace.h)
+/// </summary>
+/// <param name="filename">Output file</param>
+/// <returns>true if the file was written</returns>
+bool SearchTrace::DumpBinary(const std::string& filename) {
+	std::ofstream out(filename, std::ios::binary);
+	if (!out) {
+		std::cout << "Cannot write trace " << filename << std::endl;
+		return false;
+	}
+	auto write32 = [&](uint32_t v) { out.write((const char*)&v, sizeof(v)); };
+	auto write64 = [&](uint64_t v) { out.write((const char*)&v, sizeof(v)); };
+
+	std::lock_guard<std::mutex> lock(traceMutex);
+	out.write("C4TR", 4);
+	write32(1);
+	write32(TRACE_NUMBER_OF_EVENTS);
+	for (const char* name : traceEventNames) {
+		std::string s(name);
+		write32((uint32_t)s.size());
+		out.write(s.data(), s.size());
+	}
+	write32((uint32_t)traceBuffers.size());
+	for (auto& b : traceBuffers) {
+		uint64_t head = b->head.load(std::memory_order_acquire);
+		uint64_t size = b->records.size();
+		uint64_t first = (head > size) ? head - size : 0;
+		write32(b->tid);
+		write64(head - first);
+		for (uint64_t i = first; i < head; i++)
+			out.write((const char*)&b->records[i % size], sizeof(TraceRecord));
+	}
+	return (bool)out;
+}
@@ -0,0 +1,97 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Tracing is compiled in when C4_TRACE is 1 (the default) and then costs one test of a flag per node until SearchTrace::Enable() is called.
+// Build with C4_TRACE=0 to compile it out.
+#ifndef C4_TRACE
+#define C4_TRACE 1
+#endif
+
+enum t_TraceEvent { TRACE_SOLVE = 0, TRACE_ITERATION = 1, TRACE_ROOT_MOVE = 2, TRACE_NODE = 3, TRACE_NUMBER_OF_EVENTS = 4 };
+
+/// <summary>
+/// TraceRecord is one trace event: a span begins ('B') or ends ('E'), or an instant event ('i') occurs.  16 bytes.
+/// </summary>
+struct TraceRecord {
+	uint64_t ts_ns;		// nanoseconds since SearchTrace::Enable()
+	uint16_t event;		// t_TraceEvent
+	uint8_t phase;		// 'B', 'E' or 'i'
+	uint8_t reserved;
+	int32_t arg;		// move number, depth, column or ply, depending on the event
+};
+
+/// <summary>
+/// TraceBuffer is the ring buffer of one thread
+/// </summary>
+struct TraceBuffer {
+	unsigned int tid = 0;
+	std::vector<TraceRecord> records;
+	std::atomic<uint64_t> head{ 0 };	// number of records written; the last records.size() of them are kept
+};
+
+/// <summary>
+/// SearchTrace records where the time of a search goes: spans for each search, each iteration and each root move, and a sample of the nodes.
+/// Each thread records into its own ring buffer (lock-free: only the owning thread writes, and it publishes its position with an atomic store),
+/// keeping the most recent events once the buffer is full.  The buffers outlive their threads, so a tournament can be traced and dumped after
+/// its worker threads are gone.
+/// Enable(), Disable(), Clear() and the dumps must be called while no search is running.
+/// 
+/// Output is either Chrome trace_event JSON (open with chrome://tracing or https://ui.perfetto.dev) or a compact binary file:
+///   "C4TR", uint32 version (1), uint32 number of event names, then per name: uint32 length and the characters,
+///   uint32 number of threads, then per thread: uint32 thread id, uint64 number of records, and the TraceRecords.
+/// </summary>
+class SearchTrace
+{
+private:
+	static std::atomic<bool> t_bEnabled;
+	static unsigned int t_sampleEvery;
+
+	static TraceBuffer* ThreadBuffer(void);
+	static void Record(t_TraceEvent event, uint8_t phase, int32_t arg);
+
+public:
+	static void Enable(size_t capacityPerThread = (size_t)1 << 18, unsigned int sampleEvery = 1024);
+	static void Disable(void);
+	static void Clear(void);
+
+	/// <summary>
+	/// IsEnabled() returns true while events are recorded
+	/// </summary>
+	static inline bool IsEnabled(void) {
+		return C4_TRACE && t_bEnabled.load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	/// SampleEvery() returns the sampling period of node events: one node in SampleEvery() is recorded
+	/// </summary>
+	static inline unsigned int SampleEvery(void) {
+		return t_sampleEvery;
+	}
+
+	static inline void Begin(t_TraceEvent event, int32_t arg) { Record(event, 'B', arg); }
+	static inline void End(t_TraceEvent event, int32_t arg) { Record(event, 'E', arg); }
+	static inline void Instant(t_TraceEvent event, int32_t arg) { Record(event, 'i', arg); }
+
+	static const char* EventName(t_TraceEvent event);
+	static bool DumpChromeJSON(const std::string& filename);
+	static bool DumpBinary(const std::string& filename);
+};
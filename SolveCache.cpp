@@ -0,0 +1,141 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "SolveCache.h"
+
+/// <summary>
+/// SolveCache() creates an empty cache holding at most (about) capacity results
+/// </summary>
+/// <param name="capacity">Maximum number of results</param>
+SolveCache::SolveCache(size_t capacity) : hits(0), misses(0) {
+	size_t perShard = (capacity + SOLVECACHE_SHARDS - 1) / SOLVECACHE_SHARDS;
+	for (Shard& s : shards) {
+		s.capacity = (perShard == 0) ? 1 : perShard;
+		s.entries.reserve(s.capacity);
+		s.index.reserve(s.capacity);
+	}
+}
+
+/// <summary>
+/// SolveCache::MakeKey() builds the key of a root search
+/// </summary>
+/// <param name="b">Board configuration being searched</param>
+/// <param name="depth">Search depth</param>
+/// <param name="MoveNumber">Current move number</param>
+/// <returns>Key of the search</returns>
+SolveCacheKey SolveCache::MakeKey(Board& b, unsigned int depth, unsigned int MoveNumber) {
+	SolveCacheKey k;
+	k.red = b.GetBoard(RED);
+	k.yellow = b.GetBoard(YELLOW);
+	k.info = (unsigned int)b.GetPlayerToMove() | ((depth & 0xFF) << 8) | ((MoveNumber & 0xFF) << 16);
+	return k;
+}
+
+SolveCache::Shard& SolveCache::GetShard(const SolveCacheKey& k) {
+	return shards[(SolveCacheKeyHash()(k) >> 7) % SOLVECACHE_SHARDS];
+}
+
+/// <summary>
+/// SolveCache::Probe() looks up a root search.  A hit marks the entry as recently used.
+/// </summary>
+/// <param name="k">Key of the search</param>
+/// <param name="m">Returns the cached best move (on a hit)</param>
+/// <param name="score">Returns the cached score (on a hit)</param>
+/// <returns>true on a hit; false on a miss</returns>
+bool SolveCache::Probe(const SolveCacheKey& k, Move& m, int& score) {
+	Shard& s = GetShard(k);
+	{
+		std::lock_guard<std::mutex> lock(s.mtx);
+		auto it = s.index.find(k);
+		if (it != s.index.end()) {
+			Entry& e = s.entries[it->second];
+			e.referenced = true;
+			m = e.move;
+			score = e.score;
+			hits++;
+			return true;
+		}
+	}
+	misses++;
+	return false;
+}
+
+/// <summary>
+/// SolveCache::Store() adds the result of a root search.  When the shard is full, the CLOCK hand sweeps the entries, giving each recently used
+/// entry a second chance, and replaces the first entry that was not used since the last sweep.
+/// </summary>
+/// <param name="k">Key of the search</param>
+/// <param name="m">Best move</param>
+/// <param name="score">Score of the best move</param>
+void SolveCache::Store(const SolveCacheKey& k, Move m, int score) {
+	Shard& s = GetShard(k);
+	std::lock_guard<std::mutex> lock(s.mtx);
+
+	auto it = s.index.find(k);
+	if (it != s.index.end()) {
+		Entry& e = s.entries[it->second];
+		e.move = m;
+		e.score = score;
+		e.referenced = true;
+		return;
+	}
+
+	if (s.entries.size() < s.capacity) {
+		s.index[k] = s.entries.size();
+		s.entries.push_back({ k, m, score, false });
+		return;
+	}
+
+	for (; ; ) {
+		Entry& e = s.entries[s.hand];
+		if (e.referenced) {
+			e.referenced = false;
+			s.hand = (s.hand + 1) % s.capacity;
+			continue;
+		}
+		s.index.erase(e.key);
+		s.index[k] = s.hand;
+		e = { k, m, score, false };
+		s.hand = (s.hand + 1) % s.capacity;
+		return;
+	}
+}
+
+/// <summary>
+/// SolveCache::Clear() removes all entries and resets the hit / miss counters
+/// </summary>
+void SolveCache::Clear(void) {
+	for (Shard& s : shards) {
+		std::lock_guard<std::mutex> lock(s.mtx);
+		s.entries.clear();
+		s.index.clear();
+		s.hand = 0;
+	}
+	hits = 0;
+	misses = 0;
+}
+
+unsigned long long SolveCache::GetHits(void) const {
+	return hits;
+}
+
+unsigned long long SolveCache::GetMisses(void) const {
+	return misses;
+}
+
+size_t SolveCache::GetCapacity(void) const {
+	return shards[0].capacity * SOLVECACHE_SHARDS;
+}
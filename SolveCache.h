@@ -0,0 +1,91 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include "Board.h"
+
+#define SOLVECACHE_SHARDS 16
+
+/// <summary>
+/// SolveCacheKey identifies a root search: the position (both bitboards and the player to move), the search depth and the move number
+/// (the move number is part of the board evaluation).
+/// </summary>
+struct SolveCacheKey {
+	BitBoard red;
+	BitBoard yellow;
+	unsigned int info;	// player to move | depth << 8 | move number << 16
+
+	bool operator==(const SolveCacheKey& k) const {
+		return (red == k.red) && (yellow == k.yellow) && (info == k.info);
+	}
+};
+
+struct SolveCacheKeyHash {
+	size_t operator()(const SolveCacheKey& k) const {
+		uint64_t h = k.red * 0x9E3779B97F4A7C15ULL;
+		h ^= (k.yellow + 0xBF58476D1CE4E5B9ULL) * 0x94D049BB133111EBULL;
+		h ^= (uint64_t)k.info * 0xD6E8FEB86659FD93ULL;
+		return (size_t)(h ^ (h >> 32));
+	}
+};
+
+/// <summary>
+/// SolveCache is a bounded cache of root search results (best move and score), shared by all the solvers (and threads) that use it.
+/// When full, entries are replaced using the CLOCK algorithm (an approximation of least-recently-used).  The cache is split into shards, 
+/// each with its own lock, so that concurrent games rarely wait on each other.
+/// A cache must only be shared between solvers with the same configuration (same algorithm, no variety of play).
+/// </summary>
+class SolveCache
+{
+private:
+	struct Entry {
+		SolveCacheKey key;
+		Move move;
+		int score;
+		bool referenced;
+	};
+
+	struct Shard {
+		std::mutex mtx;
+		std::vector<Entry> entries;
+		std::unordered_map<SolveCacheKey, size_t, SolveCacheKeyHash> index;
+		size_t hand = 0;
+		size_t capacity = 0;
+	};
+
+	Shard shards[SOLVECACHE_SHARDS];
+	std::atomic<unsigned long long> hits;
+	std::atomic<unsigned long long> misses;
+
+	Shard& GetShard(const SolveCacheKey& k);
+
+public:
+	SolveCache(size_t capacity);
+
+	static SolveCacheKey MakeKey(Board& b, unsigned int depth, unsigned int MoveNumber);
+
+	bool Probe(const SolveCacheKey& k, Move& m, int& score);
+	void Store(const SolveCacheKey& k, Move m, int score);
+	void Clear(void);
+
+	unsigned long long GetHits(void) const;
+	unsigned long long GetMisses(void) const;
+	size_t GetCapacity(void) const;
+};
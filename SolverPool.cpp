@@ -0,0 +1,121 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "SolverPool.h"
+#include "Solver_ConnectFour.h"
+#include "OrderedParallel.h"
+
+SolverPool::SolverPool(void) {
+	p_nThreads = 0;
+	p_bStop = false;
+}
+
+/// <summary>
+/// SolverPool::SolverPool() copying a pool gives a pool with the same number of threads, but no workers: the workers of a solver belong to it, 
+/// not to its clones
+/// </summary>
+/// <param name="pool">Pool copied</param>
+SolverPool::SolverPool(const SolverPool& pool) {
+	p_nThreads = pool.p_nThreads;
+	p_bStop = false;
+}
+
+SolverPool& SolverPool::operator=(const SolverPool& pool) {
+	p_nThreads = pool.p_nThreads;
+	return *this;
+}
+
+SolverPool::~SolverPool(void) {
+	{
+		std::lock_guard<std::mutex> lock(p_mtx);
+		p_bStop = true;
+		p_tasks.clear();
+		for (size_t w = 0; w < p_running.size(); w++) {
+			if (p_bRunning[w])
+				p_running[w].Cancel();
+		}
+	}
+	p_cv.notify_all();
+	for (auto& t : p_threads) {
+		t.join();
+	}
+}
+
+/// <summary>
+/// SolverPool::SetNumberOfThreads() sets the number of workers; it applies when the workers are started (by the first task submitted)
+/// </summary>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread)</param>
+void SolverPool::SetNumberOfThreads(unsigned int nThreads) {
+	std::lock_guard<std::mutex> lock(p_mtx);
+	p_nThreads = nThreads;
+}
+
+/// <summary>
+/// SolverPool::Submit() queues a task, to be run by the next free worker with the worker's solver; the first task starts the workers
+/// </summary>
+/// <param name="prototype">Solver cloned for each worker, if the workers are not yet started</param>
+/// <param name="token">Token that stops the task (cancelled if the pool is destroyed while the task runs)</param>
+/// <param name="task">Task</param>
+void SolverPool::Submit(const Solver_ConnectFour& prototype, const SearchToken& token, Task task) {
+	{
+		std::lock_guard<std::mutex> lock(p_mtx);
+		if (p_threads.empty()) {
+			unsigned int n = (p_nThreads == 0) ? DefaultNumberOfThreads() : p_nThreads;
+			for (unsigned int w = 0; w < n; w++) {
+				p_solvers.emplace_back(prototype.Clone());
+			}
+			p_running.resize(n);
+			p_bRunning.assign(n, 0);
+			for (unsigned int w = 0; w < n; w++) {
+				p_threads.emplace_back(&SolverPool::Work, this, w);
+			}
+		}
+		p_tasks.emplace_back(token, std::move(task));
+	}
+	p_cv.notify_one();
+}
+
+/// <summary>
+/// SolverPool::NumberOfQueuedTasks() returns the number of tasks waiting for a worker
+/// </summary>
+/// <param name=""></param>
+/// <returns>Number of queued tasks</returns>
+size_t SolverPool::NumberOfQueuedTasks(void) {
+	std::lock_guard<std::mutex> lock(p_mtx);
+	return p_tasks.size();
+}
+
+/// <summary>
+/// SolverPool::Work() is the loop of worker w: it runs the queued tasks with its solver until the pool is destroyed
+/// </summary>
+/// <param name="w">Worker number</param>
+void SolverPool::Work(unsigned int w) {
+	for (; ; ) {
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(p_mtx);
+			p_bRunning[w] = 0;
+			p_cv.wait(lock, [&] { return p_bStop || !p_tasks.empty(); });
+			if (p_bStop)
+				return;
+			p_running[w] = p_tasks.front().first;
+			p_bRunning[w] = 1;
+			task = std::move(p_tasks.front().second);
+			p_tasks.pop_front();
+		}
+		task(p_solvers[w].get());
+	}
+}
@@ -0,0 +1,78 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+
+class Solver_ConnectFour;
+
+/// <summary>
+/// SearchToken lets another thread stop a search (see SolveBoardAsync()).  Copies of a token share its state, so the caller keeps one copy and the
+/// search polls another; polling is a single relaxed atomic load.
+/// </summary>
+class SearchToken {
+private:
+	std::shared_ptr<std::atomic<bool>> t_bCancelled;
+
+public:
+	SearchToken(void) : t_bCancelled(std::make_shared<std::atomic<bool>>(false)) {}
+	void Cancel(void) { t_bCancelled->store(true, std::memory_order_relaxed); }
+	bool IsCancelled(void) const { return t_bCancelled->load(std::memory_order_relaxed); }
+};
+
+/// <summary>
+/// SolverPool runs tasks on worker threads, each worker with its own clone of a solver.  A solver owns its pool (see 
+/// Solver_ConnectFour::SolveBoardAsync()); the workers are started, with clones of the solver as it is then configured, when the first task is 
+/// submitted.  Tasks run in the order they are submitted.  A copy of a pool (i.e., of its solver) has no workers of its own.
+/// Each task is submitted with the token that stops it.  When the pool is destroyed, the tasks still queued are dropped (so their futures report a 
+/// broken promise), the running tasks are cancelled through their tokens, and the pool waits for them to return (which a search that polls its 
+/// token does at once).
+/// </summary>
+class SolverPool
+{
+public:
+	typedef std::function<void(Solver_ConnectFour*)> Task;
+
+private:
+	std::mutex p_mtx;
+	std::condition_variable p_cv;
+	std::deque<std::pair<SearchToken, Task>> p_tasks;
+	std::vector<SearchToken> p_running;		// token of the task run by each worker
+	std::vector<char> p_bRunning;
+	std::vector<std::thread> p_threads;
+	std::vector<std::unique_ptr<Solver_ConnectFour>> p_solvers;
+	unsigned int p_nThreads;
+	bool p_bStop;
+
+	void Work(unsigned int w);
+
+public:
+	SolverPool(void);
+	SolverPool(const SolverPool& pool);
+	SolverPool& operator=(const SolverPool& pool);
+	~SolverPool(void);
+
+	void SetNumberOfThreads(unsigned int nThreads);
+	void Submit(const Solver_ConnectFour& prototype, const SearchToken& token, Task task);
+	size_t NumberOfQueuedTasks(void);
+};
@@ -0,0 +1,564 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <sstream>
+#include <iomanip>
+#include <future>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include "SolverServer.h"
+#include "FastRandom.h"
+#include "OrderedParallel.h"
+
+#if C4_UNIX_SOCKETS
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL		// a client that has gone away must not kill the server with SIGPIPE
+#else
+#define SEND_FLAGS 0
+#endif
+#endif
+
+#define MAX_REQUEST_LENGTH 4096		// longest request line accepted on a socket
+
+/// <summary>
+/// SolverServer::SolverServer() makes a server whose workers are clones of the solver (sharing its root search cache, if it has one)
+/// </summary>
+/// <param name="solver">Solver to be served (cloned; the caller keeps it)</param>
+/// <param name="nThreads">Number of workers, i.e., of searches run at the same time (0 = one per hardware thread)</param>
+/// <param name="maxClients">Maximum number of sessions served at the same time on the socket</param>
+SolverServer::SolverServer(const Solver_ConnectFour& solver, unsigned int nThreads, unsigned int maxClients) : sv_solver(solver.Clone()) {
+	sv_pool.SetNumberOfThreads(nThreads);
+	sv_maxClients = (maxClients == 0) ? 1 : maxClients;
+	sv_start = std::chrono::steady_clock::now();
+	sv_bStop = false;
+	sv_clients = 0;
+	sv_requests = 0;
+	sv_solves = 0;
+	sv_analyses = 0;
+	sv_errors = 0;
+}
+
+SolverServer::~SolverServer(void) {
+	Stop();
+}
+
+/// <summary>
+/// ParseServerPosition() reads a position written as moves from the empty board or as a position string
+/// </summary>
+static bool ParseServerPosition(const std::string& s, Board& b) {
+	if ((s.size() == POSITION_STRING_LENGTH) && (s[HEIGHT] == '/'))
+		return Board::FromPositionString(s, b);
+	return Board::FromMoves(s, b);
+}
+
+/// <summary>
+/// SolverServer::HandleRequest() serves one request of a session (see the protocol in SolverServer.h).  Searches run on the worker pool; the 
+/// calling thread waits for the result.
+/// </summary>
+/// <param name="request">Request line</param>
+/// <param name="session">State of the session (updated by newgame)</param>
+/// <param name="response">Returns the response line (empty for a blank request, which gets no response)</param>
+/// <returns>false if the session ends (quit)</returns>
+bool SolverServer::HandleRequest(const std::string& request, ServerSession& session, std::string& response) {
+	std::istringstream in(request);
+	std::string command;
+	std::vector<std::string> args;
+	in >> command;
+	for (std::string arg; in >> arg; ) {
+		args.push_back(arg);
+	}
+	response.clear();
+	if (command.empty())
+		return true;
+	sv_requests++;
+
+	if (command == "quit") {
+		response = "bye";
+		return false;
+	}
+	else if (command == "newgame") {
+		Board b;
+		if (args.size() > 1)
+			response = "error usage: newgame [position]";
+		else if (!args.empty() && !ParseServerPosition(args[0], b))
+			response = "error invalid position " + args[0];
+		else {
+			session.board = b;
+			response = "ok";
+		}
+	}
+	else if ((command == "solve") || (command == "analyze")) {
+		bool bAnalyze = (command == "analyze");
+		Board b = session.board;
+		double movetime_ms = 0.0;
+		size_t i = 0;
+		if ((i < args.size()) && (args[i] != "movetime")) {
+			if (!ParseServerPosition(args[i], b))
+				response = "error invalid position " + args[i];
+			i++;
+		}
+		if (!bAnalyze && (i + 1 < args.size()) && (args[i] == "movetime")) {
+			movetime_ms = atof(args[i + 1].c_str());
+			i += 2;
+		}
+		if (response.empty() && (i != args.size()))
+			response = bAnalyze ? "error usage: analyze [position]" : "error usage: solve [position] [movetime ms]";
+		if (response.empty())
+			Search(b, bAnalyze, movetime_ms, response);
+	}
+	else if (command == "stats")
+		response = GetStats();
+	else
+		response = "error unknown request " + command;
+
+	if (response.compare(0, 5, "error") == 0)
+		sv_errors++;
+	return true;
+}
+
+/// <summary>
+/// SolverServer::Search() runs a solve or analyze request on the worker pool and waits for its response.  Every search can be stopped: Stop() 
+/// cancels it, and it then responds with what it has found so far ("partial"; see SolveBoardUntil() and AnalyzeBoardUntil()).
+/// </summary>
+/// <param name="b">Position</param>
+/// <param name="bAnalyze">true to score every column (AnalyzeBoardUntil()); false for the best move (SolveBoardUntil())</param>
+/// <param name="movetime_ms">Time limit of the search (0 = none); the search then returns its best move so far (see SolveBoardUntil())</param>
+/// <param name="response">Returns the response</param>
+/// <returns>false if the game is already over in this position</returns>
+bool SolverServer::Search(const Board& b, bool bAnalyze, double movetime_ms, std::string& response) {
+	Board position = b;
+	if (position.IsNoMove() || position.IsWin((typePlayer)!position.GetPlayerToMove())) {
+		response = "error game over";
+		return false;
+	}
+	unsigned int MoveNumber = position.NumberOfMoves();
+	auto deadline = std::chrono::steady_clock::time_point::max();
+	if (movetime_ms > 0.0)
+		deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((long long)(1000.0 * movetime_ms));
+	if (bAnalyze)
+		sv_analyses++;
+	else
+		sv_solves++;
+
+	std::promise<std::string> result;
+	std::future<std::string> future = result.get_future();
+	SearchToken token = sv_stopToken;
+	sv_pool.Submit(*sv_solver, token, [&](Solver_ConnectFour* solver) {
+		std::ostringstream out;
+		unsigned long long nodes = solver->GetNumberOfNodes();
+		auto start = std::chrono::steady_clock::now();
+		if (bAnalyze) {
+			typeMoveScores scores;
+			SolveResult r = solver->AnalyzeBoardUntil(position, MoveNumber, deadline, token, scores);
+			out << "analysis";
+			for (const MoveScore& s : scores) {
+				out << " " << s.move << ":" << ((s.bound == SCORE_UPPER) ? "<=" : (s.bound == SCORE_LOWER) ? ">=" : "") << s.score;
+			}
+			out << " bestmove " << r.move;
+			if (!r.bComplete)
+				out << " partial";
+		}
+		else {
+			SolveResult r = solver->SolveBoardUntil(position, MoveNumber, deadline, token);
+			out << "bestmove " << r.move << " score " << r.score;
+			if (!r.bComplete)
+				out << " partial";
+		}
+		double time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		out << " nodes " << (solver->GetNumberOfNodes() - nodes) << " time_ms " << std::fixed << std::setprecision(3) << time_ms;
+		result.set_value(out.str());
+	});
+	response = future.get();
+	return true;
+}
+
+/// <summary>
+/// SolverServer::GetStats() returns the counters of the server, as the response to a stats request
+/// </summary>
+/// <param name=""></param>
+/// <returns>"stats clients n requests n solves n analyses n errors n cache_hits n cache_misses n queued n uptime_s t"</returns>
+std::string SolverServer::GetStats(void) {
+	std::ostringstream out;
+	std::shared_ptr<SolveCache> cache = sv_solver->GetSolveCache();
+	double uptime_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - sv_start).count();
+	out << "stats clients " << sv_clients << " requests " << sv_requests << " solves " << sv_solves << " analyses " << sv_analyses
+		<< " errors " << sv_errors << " cache_hits " << (cache ? cache->GetHits() : 0) << " cache_misses " << (cache ? cache->GetMisses() : 0)
+		<< " queued " << sv_pool.NumberOfQueuedTasks() << " uptime_s " << std::fixed << std::setprecision(1) << uptime_s;
+	return out.str();
+}
+
+/// <summary>
+/// SolverServer::ServeSession() serves the requests of one session until it quits, its connection ends or the server stops
+/// </summary>
+/// <param name="readLine">Reads the next request; returns false at the end of the connection</param>
+/// <param name="writeLine">Writes a response; returns false if it could not be written</param>
+void SolverServer::ServeSession(std::function<bool(std::string&)> readLine, std::function<bool(const std::string&)> writeLine) {
+	ServerSession session;
+	std::string request, response;
+	while (!sv_bStop && readLine(request)) {
+		bool bContinue = HandleRequest(request, session, response);
+		if (!response.empty() && !writeLine(response))
+			break;
+		if (!bContinue)
+			break;
+	}
+}
+
+/// <summary>
+/// SolverServer::ServeStream() serves a single session over a pair of streams (e.g., the standard input and output), until it quits or the 
+/// input ends.  Each response is flushed as it is written.
+/// </summary>
+/// <param name="in">Requests</param>
+/// <param name="out">Responses</param>
+void SolverServer::ServeStream(std::istream& in, std::ostream& out) {
+	sv_clients++;
+	ServeSession(
+		[&](std::string& line) { return (bool)std::getline(in, line); },
+		[&](const std::string& line) { out << line << std::endl; return (bool)out; });
+	sv_clients--;
+}
+
+/// <summary>
+/// SolverServer::ServeUnixSocket() listens on a Unix domain socket and serves each connection as a session, on its own thread, until Stop() is
+/// called.  Connections beyond the maximum number of clients get "error busy" and are closed.  Returns once every session has ended.
+/// </summary>
+/// <param name="path">Path of the socket (an existing socket at this path is replaced; any other file is left as it is)</param>
+/// <returns>false if the socket cannot be created, e.g., because a file that is not a socket exists at this path</returns>
+bool SolverServer::ServeUnixSocket(const std::string& path) {
+#if C4_UNIX_SOCKETS
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path)) {
+		std::cout << "Socket path too long: " << path << std::endl;
+		return false;
+	}
+	strcpy(addr.sun_path, path.c_str());
+
+	int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFd < 0) {
+		std::cout << "Cannot create socket: " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	// Replace the socket of an earlier server, but never another kind of file
+	struct stat st;
+	if (lstat(path.c_str(), &st) == 0) {
+		if (!S_ISSOCK(st.st_mode)) {
+			std::cout << "Cannot listen on " << path << ": the file exists and is not a socket" << std::endl;
+			close(listenFd);
+			return false;
+		}
+		unlink(path.c_str());
+	}
+	if ((bind(listenFd, (sockaddr*)&addr, sizeof(addr)) < 0) || (listen(listenFd, 64) < 0)) {
+		std::cout << "Cannot listen on " << path << ": " << strerror(errno) << std::endl;
+		close(listenFd);
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> lock(sv_mtx);
+		if (sv_bStop) {
+			close(listenFd);
+			unlink(path.c_str());
+			return true;
+		}
+		sv_sockets.insert(listenFd);
+	}
+
+	while (!sv_bStop) {
+		int fd = accept(listenFd, nullptr, nullptr);
+		if (fd < 0) {
+			if ((errno == EINTR) || (errno == ECONNABORTED))
+				continue;
+			break;	// the listening socket was shut down by Stop()
+		}
+		{
+			std::lock_guard<std::mutex> lock(sv_clientsMutex);
+			if (sv_clients >= sv_maxClients) {
+				const char busy[] = "error busy\n";
+				send(fd, busy, sizeof(busy) - 1, SEND_FLAGS);
+				close(fd);
+				continue;
+			}
+			sv_clients++;
+		}
+		{
+			std::lock_guard<std::mutex> lock(sv_mtx);
+			sv_sockets.insert(fd);
+		}
+		std::thread(&SolverServer::ServeSocket, this, fd).detach();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sv_mtx);
+		sv_sockets.erase(listenFd);
+		close(listenFd);
+	}
+	unlink(path.c_str());
+
+	// Wait for the sessions to end (Stop() has shut their connections down)
+	std::unique_lock<std::mutex> lock(sv_clientsMutex);
+	sv_clientsDone.wait(lock, [&] { return sv_clients == 0; });
+	return true;
+#else
+	std::cout << "Unix domain sockets are not available (C4_UNIX_SOCKETS=0)" << std::endl;
+	return false;
+#endif
+}
+
+/// <summary>
+/// SolverServer::ServeSocket() serves the session of a connection, on its own thread, then closes the connection
+/// </summary>
+/// <param name="fd">Socket of the connection</param>
+void SolverServer::ServeSocket(int fd) {
+#if C4_UNIX_SOCKETS
+	std::string pending;
+	ServeSession(
+		[&](std::string& line) {
+			for (; ; ) {
+				size_t eol = pending.find('\n');
+				if (eol != std::string::npos) {
+					line.assign(pending, 0, eol);
+					pending.erase(0, eol + 1);
+					return true;
+				}
+				if (pending.size() > MAX_REQUEST_LENGTH)
+					return false;
+				char buffer[MAX_REQUEST_LENGTH];
+				ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+				if ((n < 0) && (errno == EINTR))
+					continue;
+				if (n <= 0)
+					return false;
+				pending.append(buffer, (size_t)n);
+			}
+		},
+		[&](const std::string& line) {
+			std::string s = line + "\n";
+			for (size_t sent = 0; sent < s.size(); ) {
+				ssize_t n = send(fd, s.data() + sent, s.size() - sent, SEND_FLAGS);
+				if ((n < 0) && (errno == EINTR))
+					continue;
+				if (n <= 0)
+					return false;
+				sent += (size_t)n;
+			}
+			return true;
+		});
+
+	{
+		std::lock_guard<std::mutex> lock(sv_mtx);
+		sv_sockets.erase(fd);
+		close(fd);
+	}
+	std::lock_guard<std::mutex> lock(sv_clientsMutex);
+	sv_clients--;
+	sv_clientsDone.notify_all();
+#endif
+}
+
+/// <summary>
+/// SolverServer::Stop() stops the server: no new request is served, running searches return at once (with a partial result, for solvers that can
+/// stop a search part way), and the connections of the socket server are shut down so that ServeUnixSocket() returns.
+/// </summary>
+/// <param name=""></param>
+void SolverServer::Stop(void) {
+	sv_bStop = true;
+	sv_stopToken.Cancel();
+#if C4_UNIX_SOCKETS
+	std::lock_guard<std::mutex> lock(sv_mtx);
+	for (int fd : sv_sockets) {
+		shutdown(fd, SHUT_RDWR);
+	}
+#endif
+}
+
+//
+// Load benchmark
+//
+
+#if C4_UNIX_SOCKETS
+/// <summary>
+/// ConnectUnixSocket() connects to a Unix domain socket, retrying for up to a second while the server starts
+/// </summary>
+static int ConnectUnixSocket(const std::string& path) {
+	sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+	for (int attempt = 0; attempt < 100; attempt++) {
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return -1;
+		if (connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0)
+			return fd;
+		close(fd);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return -1;
+}
+
+/// <summary>
+/// Request() sends a request on a connection and reads its response line
+/// </summary>
+static bool Request(int fd, const std::string& request, std::string& response) {
+	std::string s = request + "\n";
+	if (send(fd, s.data(), s.size(), SEND_FLAGS) != (ssize_t)s.size())
+		return false;
+	response.clear();
+	for (char c; ; ) {
+		ssize_t n = recv(fd, &c, 1, 0);
+		if (n <= 0)
+			return false;
+		if (c == '\n')
+			return true;
+		response += c;
+	}
+}
+
+/// <summary>
+/// Percentile() returns the value below which the fraction q of the sorted values fall
+/// </summary>
+static double Percentile(const std::vector<double>& sorted, double q) {
+	if (sorted.empty())
+		return 0.0;
+	size_t i = std::min(sorted.size() - 1, (size_t)(q * sorted.size()));
+	return sorted[i];
+}
+#endif
+
+/// <summary>
+/// BenchmarkServer() measures the socket server under load: nClients clients connect at the same time, and each sends nRequests solve requests,
+/// one at a time, for positions drawn from a set of 256 random positions (so that, as in production, positions repeat and the resident cache 
+/// answers some of them).  It reports the throughput, the latency of the requests (mean, median, 90th and 99th percentiles, maximum) and, for
+/// comparison, the cold start that a process per query pays before its first answer: building the solver, allocating its cache and searching.
+/// </summary>
+/// <param name="solver">Solver to be served (its root search cache, if any, is shared by the server's workers)</param>
+/// <param name="path">Path of the server's socket</param>
+/// <param name="nThreads">Number of workers of the server (0 = one per hardware thread)</param>
+/// <param name="nClients">Number of concurrent clients</param>
+/// <param name="nRequests">Number of requests of each client</param>
+/// <returns>false if the server could not be started or a request failed</returns>
+bool BenchmarkServer(const Solver_ConnectFour& solver, const std::string& path, unsigned int nThreads, unsigned int nClients, unsigned int nRequests) {
+#if C4_UNIX_SOCKETS
+	// Random positions, 4 to 15 moves deep, in which the game is not over
+	std::vector<std::string> positions;
+	FastRandom rng(20240101);
+	while (positions.size() < 256) {
+		std::string moves;
+		unsigned int n = 4 + rng.NextBounded(12);
+		Board b;
+		for (unsigned int tries = 0; (tries < 100) && (moves.size() < n); tries++) {
+			std::string next = moves + (char)('1' + rng.NextBounded(WIDTH));
+			if (Board::FromMoves(next, b))
+				moves = next;
+		}
+		if (Board::FromMoves(moves, b) && !b.IsNoMove() && !b.IsWin((typePlayer)!b.GetPlayerToMove()))
+			positions.push_back(moves);
+	}
+
+	// Cold start: what a new process does before its first answer (the process start itself is not counted)
+	auto c_start = std::chrono::steady_clock::now();
+	{
+		std::unique_ptr<Solver_ConnectFour> cold(solver.Clone());
+		std::shared_ptr<SolveCache> cache = cold->GetSolveCache();
+		if (cache)
+			cold->EnableSolveCache(cache->GetCapacity());
+		Board b;
+		Board::FromMoves(positions[0], b);
+		cold->SolveBoard(b, b.NumberOfMoves());
+	}
+	double cold_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - c_start).count();
+
+	SolverServer server(solver, nThreads, nClients);
+	bool bListening = true;
+	std::thread serverThread([&] { bListening = server.ServeUnixSocket(path); });
+
+	std::vector<std::vector<double>> latencies(nClients);
+	std::atomic<unsigned int> failures(0);
+	std::vector<std::thread> clients;
+	auto b_start = std::chrono::steady_clock::now();
+	for (unsigned int c = 0; c < nClients; c++) {
+		clients.emplace_back([&, c] {
+			int fd = ConnectUnixSocket(path);
+			if (fd < 0) {
+				failures++;
+				return;
+			}
+			FastRandom clientRng(c + 1);
+			std::string response;
+			for (unsigned int r = 0; r < nRequests; r++) {
+				const std::string& moves = positions[clientRng.NextBounded((unsigned int)positions.size())];
+				auto r_start = std::chrono::steady_clock::now();
+				if (!Request(fd, "solve " + moves, response) || (response.compare(0, 8, "bestmove") != 0)) {
+					failures++;
+					break;
+				}
+				latencies[c].push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - r_start).count());
+			}
+			Request(fd, "quit", response);
+			close(fd);
+		});
+	}
+	for (auto& t : clients) {
+		t.join();
+	}
+	double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - b_start).count();
+	std::string stats = server.GetStats();
+	server.Stop();
+	serverThread.join();
+	if (!bListening)
+		return false;
+
+	std::vector<double> all;
+	double total_ms = 0.0;
+	for (auto& l : latencies) {
+		for (double ms : l) {
+			all.push_back(ms);
+			total_ms += ms;
+		}
+	}
+	std::sort(all.begin(), all.end());
+
+	std::cout << "Server Benchmark: " << solver.GetFingerprint() << ", " << nClients << " clients x " << nRequests << " requests, "
+		<< ((nThreads == 0) ? DefaultNumberOfThreads() : nThreads) << " workers" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Requests Served: " << all.size() << " in " << elapsed_s << " s";
+	if (failures != 0)
+		std::cout << " (" << failures << " failed)";
+	std::cout << std::endl;
+	if (elapsed_s > 0.0)
+		std::cout << "Throughput: " << std::setprecision(1) << all.size() / elapsed_s << " requests/s" << std::setprecision(3) << std::endl;
+	if (!all.empty()) {
+		std::cout << "Latency (ms): mean " << total_ms / all.size() << ", p50 " << Percentile(all, 0.50) << ", p90 " << Percentile(all, 0.90)
+			<< ", p99 " << Percentile(all, 0.99) << ", max " << all.back() << std::endl;
+	}
+	std::cout << "Cold Start (solver, cache and first search, ms): " << cold_ms << std::endl;
+	std::cout << "Server: " << stats << std::endl;
+	std::cout << std::defaultfloat;
+	return failures == 0;
+#else
+	std::cout << "Unix domain sockets are not available (C4_UNIX_SOCKETS=0)" << std::endl;
+	return false;
+#endif
+}
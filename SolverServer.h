@@ -0,0 +1,108 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include "Solver_ConnectFour.h"
+
+/*
+
+Server mode: a resident solver answers requests, one per line, over the standard input / output or a Unix domain socket.  The solver's clones 
+(one per worker) and its root search cache stay in memory between requests, so a query does not pay for starting a process, building a solver
+or allocating its cache.  Each client has a current position, the empty board until it starts a new game.  Requests and responses:
+
+  newgame [position]                    ok                                      the client's position becomes position (the empty board by default)
+  solve [position] [movetime ms]        bestmove m score s nodes n time_ms t    best move of position (the client's position by default), searched
+                                        [partial]                               for at most ms milliseconds if given ("partial": stopped early)
+  analyze [position]                    analysis c:s ... bestmove m [partial]   score of each valid column c (see AnalyzeBoard()); "partial": the
+                                                                                server stopped, only the columns listed were scored
+  stats                                 stats clients n requests n ...          counters of the server since it started
+  quit                                  bye                                     ends the session (and, on the standard input, the server)
+
+A position is written as moves from the empty board (e.g., 4453) or as a position string (see Board::ToPositionString()).  A request that cannot 
+be served gets "error message".  Sessions are served concurrently (up to a maximum number of clients; more are turned away with "error busy"), 
+but all the searches run on a fixed pool of workers, so the load on the machine is bounded however many clients there are.
+Build with C4_UNIX_SOCKETS=0 to leave the socket server out (it is only available on Unix-like systems).
+
+*/
+
+#ifndef C4_UNIX_SOCKETS
+#if defined(__unix__) || defined(__APPLE__)
+#define C4_UNIX_SOCKETS 1
+#else
+#define C4_UNIX_SOCKETS 0
+#endif
+#endif
+
+/// <summary>
+/// ServerSession is the state of one client of a SolverServer: its current position
+/// </summary>
+struct ServerSession {
+	Board board;
+};
+
+/// <summary>
+/// SolverServer serves solve and analyze requests from any number of sessions with a pool of clones of a solver (see the protocol above)
+/// </summary>
+class SolverServer
+{
+private:
+	std::unique_ptr<Solver_ConnectFour> sv_solver;	// prototype of the workers' solvers (shares its cache with them)
+	SolverPool sv_pool;
+	unsigned int sv_maxClients;
+	SearchToken sv_stopToken;	// cancelled by Stop(): running searches return at once
+	std::chrono::steady_clock::time_point sv_start;
+
+	std::atomic<bool> sv_bStop;
+	std::mutex sv_clientsMutex;
+	std::condition_variable sv_clientsDone;	// notified as each session of the socket server ends
+	std::atomic<unsigned int> sv_clients;
+	std::atomic<unsigned long long> sv_requests;
+	std::atomic<unsigned long long> sv_solves;
+	std::atomic<unsigned long long> sv_analyses;
+	std::atomic<unsigned long long> sv_errors;
+
+	// Socket server
+	std::mutex sv_mtx;
+	std::set<int> sv_sockets;	// listening socket and the sockets of the sessions, closed by Stop()
+
+	bool Search(const Board& b, bool bAnalyze, double movetime_ms, std::string& response);
+	void ServeSession(std::function<bool(std::string&)> readLine, std::function<bool(const std::string&)> writeLine);
+	void ServeSocket(int fd);
+
+public:
+	SolverServer(const Solver_ConnectFour& solver, unsigned int nThreads = 0, unsigned int maxClients = 64);
+	~SolverServer(void);
+
+	bool HandleRequest(const std::string& request, ServerSession& session, std::string& response);
+	void ServeStream(std::istream& in, std::ostream& out);
+	bool ServeUnixSocket(const std::string& path);
+	void Stop(void);
+	std::string GetStats(void);
+};
+
+// Load benchmark of the socket server
+bool BenchmarkServer(const Solver_ConnectFour& solver, const std::string& path, unsigned int nThreads, unsigned int nClients, unsigned int nRequests);
@@ -20,6 +20,9 @@ Solver_ConnectFour::Solver_ConnectFour(void) {
 	s_board.InitBoard();
 	s_mh.ResetHistory();
 	s_playerToMove = RED;
+	s_lastScore = 0;
+	s_totalNodes = 0;
+	s_rootMoveNumber = 0;
 	SetPlayerName("Generic Connect Four Solver");
 }
 
@@ -42,4 +45,314 @@ std::string Solver_ConnectFour::GetPlayerName(void) {
 /// <param name="s">New name of the solver</param>
 void Solver_ConnectFour::SetPlayerName(std::string s) {
 	s_PlayerName = s;
+}
+
+/// <summary>
+/// Solver_ConnectFour::SeedRandom() seeds the solver's random number generator from a (match seed, game index, side) tuple.
+/// MatchPlay() seeds both solvers before every game, so any game of a match can be replayed exactly, whatever thread it was played on.
+/// </summary>
+/// <param name="matchSeed">Seed of the match</param>
+/// <param name="gameIndex">Game number within the match</param>
+/// <param name="side">Side played by this solver in the game</param>
+void Solver_ConnectFour::SeedRandom(uint64_t matchSeed, uint64_t gameIndex, typePlayer side) {
+	uint64_t x = matchSeed;
+	uint64_t h = FastRandom::SplitMix64(x);
+	x = h ^ gameIndex;
+	h = FastRandom::SplitMix64(x);
+	x = h ^ (uint64_t)side;
+	s_rng.Seed(FastRandom::SplitMix64(x));
+}
+
+/// <summary>
+/// Solver_ConnectFour::IsDeterministic() returns true if the solver always plays the same move for the same board.  By default, a solver is
+/// assumed to be non-deterministic; derived classes override this.
+/// </summary>
+/// <param name=""></param>
+/// <returns>false</returns>
+bool Solver_ConnectFour::IsDeterministic(void) const {
+	return false;
+}
+
+/// <summary>
+/// Solver_ConnectFour::GetFingerprint() returns a string that identifies the solver's configuration (algorithm and parameters).
+/// MatchPlay() uses it, for deterministic solvers, to recognize games that have already been played.
+/// </summary>
+/// <param name=""></param>
+/// <returns>s_PlayerName</returns>
+std::string Solver_ConnectFour::GetFingerprint(void) const {
+	return s_PlayerName;
+}
+
+/// <summary>
+/// Solver_ConnectFour::SolveBoard() with a clock is used for tournament play under a time control.  Solvers that can size their search to the 
+/// time left override it; by default, the solver searches as it would without a clock.
+/// </summary>
+/// <param name="b">Board configuration to be searched</param>
+/// <param name="MoveNumber">Current MoveNumber</param>
+/// <param name="clock">Time left on the solver's clock and increment per move</param>
+/// <returns>Best move</returns>
+Move Solver_ConnectFour::SolveBoard(const Board& b, unsigned int MoveNumber, const SolverClock&) {
+	return SolveBoard(b, MoveNumber);
+}
+
+/// <summary>
+/// Solver_ConnectFour::SolveBoardUntil() searches a board until the search completes, the deadline passes or the token is cancelled, whichever 
+/// comes first.  Solvers that can stop a search part way override it and return their best move so far; by default, the search always runs to 
+/// completion once started, and only a search that has not started by the deadline (or is cancelled first) is skipped, returning the first valid
+/// move of the board's move sequence.
+/// </summary>
+/// <param name="b">Board configuration to be searched</param>
+/// <param name="MoveNumber">Current MoveNumber</param>
+/// <param name="deadline">Time by which the search must stop</param>
+/// <param name="token">Token that cancels the search</param>
+/// <returns>Best move found, with its score and whether the search completed</returns>
+SolveResult Solver_ConnectFour::SolveBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point deadline, const SearchToken& token) {
+	SolveResult r;
+	auto start = std::chrono::steady_clock::now();
+	if (token.IsCancelled() || (start >= deadline)) {
+		Board position = b;
+		for (Move m : position.MoveSequence) {
+			if (position.IsValidMove(m)) {
+				r.move = m;
+				break;
+			}
+		}
+		return r;
+	}
+	r.move = SolveBoard(b, MoveNumber);
+	r.score = GetLastScore();
+	r.bComplete = true;
+	r.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return r;
+}
+
+/// <summary>
+/// Solver_ConnectFour::AnalyzeBoard() scores every valid column for the player to move, e.g., to show the value of each column.  By default, each 
+/// column is played and the solver is asked for the opponent's best reply (SolveReply()): the column's score is minus the score of that reply 
+/// (solvers that do not score their moves give 0).  A column that wins is scored as the minimax solvers score a win on the next move, and one that 
+/// fills the board as a draw.  Each column is a separate search, so nothing is shared between them; solvers that can share the work override it.
+/// </summary>
+/// <param name="b">Board configuration to be analyzed</param>
+/// <param name="MoveNumber">Current MoveNumber</param>
+/// <param name="scores">Returns the score of each valid column, from the point of view of the player to move (exact by default)</param>
+/// <param name="bExact">false if only the best column needs an exact score (the others may be bounds); ignored by default</param>
+/// <returns>Best move (the first column, in the board's move sequence, with the highest score); 0 if there is no valid move</returns>
+Move Solver_ConnectFour::AnalyzeBoard(const Board& b, unsigned int MoveNumber, typeMoveScores& scores, bool) {
+	Board position = b;
+	typePlayer p = position.GetPlayerToMove();
+	MoveScore columns[WIDTH + 1];
+	scores.clear();
+
+	for (Move m = 1; m <= WIDTH; m++) {
+		if (!position.IsValidMove(m))
+			continue;
+		columns[m].move = m;
+		position.MakeMove(m, p);
+		if (position.IsWin(p))
+			columns[m].score = (WIDTH * (HEIGHT + 1) - (int)MoveNumber) / 2;
+		else if (position.IsNoMove())
+			columns[m].score = 0;
+		else {
+			SolveReply(position, MoveNumber + 1);
+			columns[m].score = -GetLastScore();
+		}
+		position.TakeBackMove(m, p);
+		scores.push_back(columns[m]);
+	}
+
+	Move bestMove = 0;
+	for (Move m : position.MoveSequence) {
+		if ((columns[m].move != 0) && ((bestMove == 0) || (columns[m].score > columns[bestMove].score)))
+			bestMove = m;
+	}
+	s_lastScore = (bestMove != 0) ? columns[bestMove].score : 0;
+	return bestMove;
+}
+
+/// <summary>
+/// Solver_ConnectFour::AnalyzeBoardUntil() scores every valid column (see AnalyzeBoard()) until the analysis completes, the deadline passes or 
+/// the token is cancelled, whichever comes first.  Solvers that can stop an analysis part way override it and return the columns scored so far;
+/// by default, the analysis always runs to completion once started, and only an analysis that has not started by the deadline (or is cancelled
+/// first) is skipped, returning no scores.
+/// </summary>
+/// <param name="b">Board configuration to be analyzed</param>
+/// <param name="MoveNumber">Current MoveNumber</param>
+/// <param name="deadline">Time by which the analysis must stop</param>
+/// <param name="token">Token that cancels the analysis</param>
+/// <param name="scores">Returns the score of each column scored (every valid column if the analysis completed)</param>
+/// <param name="bExact">false if only the best column needs an exact score (see AnalyzeBoard())</param>
+/// <returns>Best move of the columns scored (0 if none), with its score and whether the analysis completed</returns>
+SolveResult Solver_ConnectFour::AnalyzeBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point deadline, 
+	const SearchToken& token, typeMoveScores& scores, bool bExact) {
+	SolveResult r;
+	auto start = std::chrono::steady_clock::now();
+	scores.clear();
+	if (token.IsCancelled() || (start >= deadline))
+		return r;
+	r.move = AnalyzeBoard(b, MoveNumber, scores, bExact);
+	r.score = GetLastScore();
+	r.bComplete = true;
+	r.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return r;
+}
+
+/// <summary>
+/// Solver_ConnectFour::SolveReply() finds the opponent's best reply to a column for the default AnalyzeBoard(), which scores the column as minus 
+/// the score of the reply.  Solvers with a depth limit search the reply one ply shallower than SolveBoard(), so that each column is searched as 
+/// deep as SolveBoard() searches it.  By default, SolveBoard().
+/// </summary>
+/// <param name="b">Board configuration after the column has been played</param>
+/// <param name="MoveNumber">Current MoveNumber</param>
+/// <returns>Best reply</returns>
+Move Solver_ConnectFour::SolveReply(const Board& b, unsigned int MoveNumber) {
+	return SolveBoard(b, MoveNumber);
+}
+
+/// <summary>
+/// Solver_ConnectFour::GetNumberOfNodes() returns the number of nodes the solver has searched since it was created.  The nodes searched for
+/// one move are the difference between the counts after and before SolveBoard().  Solvers that do not search return 0.
+/// </summary>
+/// <param name=""></param>
+/// <returns>s_totalNodes</returns>
+unsigned long long Solver_ConnectFour::GetNumberOfNodes(void) const {
+	return s_totalNodes;
+}
+
+/// <summary>
+/// Solver_ConnectFour::GetLastSearchStats() returns the statistics of the last search (zeros for solvers that do not search, or if the
+/// counters are compiled out with C4_SEARCH_STATS=0)
+/// </summary>
+/// <param name=""></param>
+/// <returns>s_lastStats</returns>
+const SearchStats& Solver_ConnectFour::GetLastSearchStats(void) const {
+	return s_lastStats;
+}
+
+/// <summary>
+/// Solver_ConnectFour::BeginSearch() resets the search counters at the start of a search (SolveBoard())
+/// </summary>
+/// <param name="MoveNumber">Move number at the root of the search</param>
+void Solver_ConnectFour::BeginSearch(unsigned int MoveNumber) {
+	s_counters.Reset();
+	s_rootMoveNumber = MoveNumber;
+	s_searchStart = std::chrono::steady_clock::now();
+}
+
+/// <summary>
+/// Solver_ConnectFour::EndSearch() keeps the statistics of the search that just ended
+/// </summary>
+/// <param name=""></param>
+void Solver_ConnectFour::EndSearch(void) {
+	s_lastStats = s_counters.stats;
+	s_lastStats.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_searchStart).count();
+	s_totalNodes += s_lastStats.nodes;
+}
+
+/// <summary>
+/// Solver_ConnectFour::GetLastScore() returns the score of the move returned by the last call to SolveBoard() (0 if the solver does not score its moves)
+/// </summary>
+/// <param name=""></param>
+/// <returns>s_lastScore</returns>
+int Solver_ConnectFour::GetLastScore(void) {
+	return s_lastScore;
+}
+
+//
+// Asynchronous search
+//
+
+/// <summary>
+/// Solver_ConnectFour::SolveBoardAsync() starts a search on the solver's worker pool and returns at once.  The result is delivered through the 
+/// future; the search stops at the deadline or when the token is cancelled, and the result then holds the best move found so far (see 
+/// SolveBoardUntil()).  The workers are clones of the solver, made when the first search is submitted (later changes to the solver's 
+/// configuration do not reach them); searches wait in order for a free worker.  Destroying the solver cancels its running searches and drops
+/// the queued ones.  E.g.:
+///   AsyncSolve search = solver.SolveBoardAsync(b, MoveNumber, std::chrono::steady_clock::now() + std::chrono::seconds(2));
+///   ...
+///   search.token.Cancel();	// optional: stop early
+///   SolveResult r = search.result.get();
+/// </summary>
+/// <param name="b">Board configuration to be searched (copied)</param>
+/// <param name="MoveNumber">Current MoveNumber</param>
+/// <param name="deadline">Time by which the search must stop (none by default)</param>
+/// <returns>Future of the result, and the token that cancels the search</returns>
+AsyncSolve Solver_ConnectFour::SolveBoardAsync(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point deadline) {
+	AsyncSolve search;
+	std::shared_ptr<std::promise<SolveResult>> promise = std::make_shared<std::promise<SolveResult>>();
+	search.result = promise->get_future();
+
+	SearchToken token = search.token;
+	Board position = b;
+	s_pool.Submit(*this, token, [promise, token, position, MoveNumber, deadline](Solver_ConnectFour* solver) {
+		promise->set_value(solver->SolveBoardUntil(position, MoveNumber, deadline, token));
+	});
+	return search;
+}
+
+/// <summary>
+/// Solver_ConnectFour::SetAsyncThreads() sets the number of workers of SolveBoardAsync(); it must be called before the first asynchronous search
+/// </summary>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread, the default)</param>
+void Solver_ConnectFour::SetAsyncThreads(unsigned int nThreads) {
+	s_pool.SetNumberOfThreads(nThreads);
+}
+
+//
+// Root search cache
+//
+
+/// <summary>
+/// Solver_ConnectFour::EnableSolveCache() gives the solver a new root search cache of the specified capacity (0 removes the cache).
+/// Clones made afterwards share the cache.  Only deterministic solvers use the cache.
+/// </summary>
+/// <param name="capacity">Maximum number of cached searches</param>
+void Solver_ConnectFour::EnableSolveCache(size_t capacity) {
+	if (capacity == 0)
+		s_cache.reset();
+	else
+		s_cache = std::make_shared<SolveCache>(capacity);
+}
+
+/// <summary>
+/// Solver_ConnectFour::SetSolveCache() makes the solver use an existing cache (e.g., one shared with other solvers of the same configuration)
+/// </summary>
+/// <param name="cache">Cache to use (nullptr for none)</param>
+void Solver_ConnectFour::SetSolveCache(std::shared_ptr<SolveCache> cache) {
+	s_cache = cache;
+}
+
+/// <summary>
+/// Solver_ConnectFour::GetSolveCache() returns the cache used by the solver (nullptr if none), e.g., to read the hit / miss counters
+/// </summary>
+/// <param name=""></param>
+/// <returns>s_cache</returns>
+std::shared_ptr<SolveCache> Solver_ConnectFour::GetSolveCache(void) {
+	return s_cache;
+}
+
+/// <summary>
+/// Solver_ConnectFour::ProbeSolveCache() looks up the search of s_board at the specified depth.  On a hit, the search can be skipped entirely.
+/// </summary>
+/// <param name="depth">Search depth</param>
+/// <param name="MoveNumber">Current move number</param>
+/// <param name="m">Returns the cached best move (on a hit)</param>
+/// <returns>true on a hit (s_lastScore is set to the cached score); false on a miss or if there is no cache</returns>
+bool Solver_ConnectFour::ProbeSolveCache(unsigned int depth, unsigned int MoveNumber, Move& m) {
+	if (!s_cache || !IsDeterministic())
+		return false;
+	bool bHit = s_cache->Probe(SolveCache::MakeKey(s_board, depth, MoveNumber), m, s_lastScore);
+	s_counters.CacheProbe(bHit);
+	return bHit;
+}
+
+/// <summary>
+/// Solver_ConnectFour::StoreSolveCache() stores the result (m and s_lastScore) of the search of s_board at the specified depth
+/// </summary>
+/// <param name="depth">Search depth</param>
+/// <param name="MoveNumber">Current move number</param>
+/// <param name="m">Best move</param>
+void Solver_ConnectFour::StoreSolveCache(unsigned int depth, unsigned int MoveNumber, Move m) {
+	if (!s_cache || !IsDeterministic())
+		return;
+	s_cache->Store(SolveCache::MakeKey(s_board, depth, MoveNumber), m, s_lastScore);
 }
\ No newline at end of file
@@ -18,6 +18,54 @@
 #include<iostream>
 #include "Board.h"
 #include "MoveHistory.h"
+#include "FastRandom.h"
+#include "SolveCache.h"
+#include "SearchStats.h"
+#include "SolverPool.h"
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <future>
+
+/// <summary>
+/// SolverClock is the time available to a solver under a chess-clock time control (base time plus an increment per move), in milliseconds
+/// </summary>
+struct SolverClock {
+	double remaining_ms = 0.0;	// time left on the solver's clock, before this move
+	double increment_ms = 0.0;	// time added to the clock after each move
+};
+
+/// <summary>
+/// SolveResult is the outcome of a search that may be stopped before it completes (see SolveBoardUntil())
+/// </summary>
+struct SolveResult {
+	Move move = 0;
+	int score = 0;
+	bool bComplete = false;		// false if the search was cancelled or ran out of time: move (and score) are then the best found so far
+	double time_ms = 0.0;
+};
+
+/// <summary>
+/// AsyncSolve is a search running on a solver's worker pool: the future of its result, and the token that cancels it
+/// </summary>
+struct AsyncSolve {
+	std::future<SolveResult> result;
+	SearchToken token;
+};
+
+/// <summary>
+/// MoveScore is the value of one column for the player to move (see AnalyzeBoard()): exact, or a bound on the exact value when the search 
+/// only had to show that the column is no better (SCORE_UPPER) or no worse (SCORE_LOWER) than another
+/// </summary>
+enum t_ScoreBound { SCORE_EXACT = 0, SCORE_LOWER = 1, SCORE_UPPER = 2 };
+
+struct MoveScore {
+	Move move = 0;
+	int score = 0;
+	t_ScoreBound bound = SCORE_EXACT;
+};
+
+typedef FixedVector<MoveScore, WIDTH> typeMoveScores;	// one score per valid column, in column order
 
 /// <summary>
 /// Solver_ConnectFour is the base class for our Connect Four solvers
@@ -30,13 +78,55 @@ protected:
 	MoveHistory s_mh;
 	typePlayer s_playerToMove;
 	typePlayer s_winner;
+	FastRandom s_rng;	// each solver instance owns its random number generator (no shared state between solvers or threads)
+	int s_lastScore;	// score of the move returned by the last search
+	std::shared_ptr<SolveCache> s_cache;	// optional root search cache (shared with clones of this solver)
+
+	// Search statistics (see SearchStats.h)
+	t_SearchCounters s_counters;	// counters of the search in progress
+	SearchStats s_lastStats;		// statistics of the last search
+	unsigned long long s_totalNodes;	// nodes searched since the solver was created
+	unsigned int s_rootMoveNumber;	// move number at the root of the search in progress (ply = MoveNumber - s_rootMoveNumber)
+	std::chrono::steady_clock::time_point s_searchStart;
+
+	SolverPool s_pool;	// workers of SolveBoardAsync() (started on first use)
+
+	void BeginSearch(unsigned int MoveNumber);
+	void EndSearch(void);
+	bool ProbeSolveCache(unsigned int depth, unsigned int MoveNumber, Move& m);
+	void StoreSolveCache(unsigned int depth, unsigned int MoveNumber, Move m);
+	virtual Move SolveReply(const Board& b, unsigned int MoveNumber);	// Opponent's best reply to a column, for AnalyzeBoard(); by default, SolveBoard()
 
 public:
 	Solver_ConnectFour(void);
+	virtual ~Solver_ConnectFour(void) {}
 
 	std::string GetPlayerName(void);
 	void SetPlayerName(std::string s); 
+	void SeedRandom(uint64_t matchSeed, uint64_t gameIndex, typePlayer side);
+	int GetLastScore(void);
+	const SearchStats& GetLastSearchStats(void) const;
+
+	// Asynchronous search
+	AsyncSolve SolveBoardAsync(const Board& b, unsigned int MoveNumber, 
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+	void SetAsyncThreads(unsigned int nThreads);
+
+	// Root search cache
+	void EnableSolveCache(size_t capacity);
+	void SetSolveCache(std::shared_ptr<SolveCache> cache);
+	std::shared_ptr<SolveCache> GetSolveCache(void);
 
 	virtual Move SolveBoard(const Board& b, unsigned int MoveNumber) = 0;	// To be defined in derived classes
+	virtual Move SolveBoard(const Board& b, unsigned int MoveNumber, const SolverClock& clock);	// Timed play; by default the clock is ignored
+	virtual SolveResult SolveBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point deadline, const SearchToken& token);
+	virtual Move AnalyzeBoard(const Board& b, unsigned int MoveNumber, typeMoveScores& scores, bool bExact = true);	// Scores every valid column
+	virtual SolveResult AnalyzeBoardUntil(const Board& b, unsigned int MoveNumber, std::chrono::steady_clock::time_point deadline, const SearchToken& token, 
+		typeMoveScores& scores, bool bExact = true);
+	virtual Solver_ConnectFour* Clone(void) const = 0;	// Returns an independent copy (same configuration) owned by the caller; used to give each thread its own solver
+
+	virtual bool IsDeterministic(void) const;			// true if the solver always returns the same move for the same board (i.e., it never uses its randomizer)
+	virtual std::string GetFingerprint(void) const;		// Identifies the solver's configuration; two solvers with the same fingerprint play identically
+	unsigned long long GetNumberOfNodes(void) const;	// Nodes searched since the solver was created (0 for solvers that do not search, or without C4_SEARCH_STATS)
 };
 
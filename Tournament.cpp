@@ -0,0 +1,1004 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <iostream>
+#include <chrono>
+#include <sstream>
+#include <memory>
+#include <iomanip>
+#include <algorithm>
+#include "Tournament.h"
+#include "OrderedParallel.h"
+#include "EloRating.h"
+
+/// <summary>
+/// Tournament() sets up a tournament with no solvers; by default every game is displayed with its number, its moves and its winner
+/// </summary>
+Tournament::Tournament(void) {
+    t_bShowWinner = true;
+    t_bShowMoveByMove = true;
+    t_bShowMoveHistory = false;
+    t_bShowGameNumber = true;
+    t_bShowMoveStats = true;
+    t_bShowMoveStatsPerMoveNumber = true;
+    t_resultsFormat = RESULTS_CSV;
+    t_baseTime_ms = 0.0;
+    t_increment_ms = 0.0;
+}
+
+/// <summary>
+/// Tournament::SetDisplay() selects what is displayed for each game
+/// </summary>
+/// <param name="bShowWinner">Display the winner of each game</param>
+/// <param name="bShowMoveByMove">Display the moves of each game</param>
+/// <param name="bShowMoveHistory">Display the move history at the end of each game</param>
+/// <param name="bShowGameNumber">Display the number of each game</param>
+void Tournament::SetDisplay(bool bShowWinner, bool bShowMoveByMove, bool bShowMoveHistory, bool bShowGameNumber) {
+    t_bShowWinner = bShowWinner;
+    t_bShowMoveByMove = bShowMoveByMove;
+    t_bShowMoveHistory = bShowMoveHistory;
+    t_bShowGameNumber = bShowGameNumber;
+}
+
+/// <summary>
+/// Tournament::SetMoveStats() selects the move statistics displayed at the end of each match: for each solver, the time taken by SolveBoard() 
+/// (p50 / p90 / p99 / max), the nodes searched per move and the nodes per second, over all its moves and (optionally) per move number.
+/// Every move can also be appended to a CSV file (match seed, game, solver, side, move number, time, nodes) to track regressions.
+/// </summary>
+/// <param name="bShowMoveStats">Display the move statistics</param>
+/// <param name="bPerMoveNumber">Also display the statistics per move number</param>
+/// <param name="csvFile">CSV file to which every move is appended (empty = none)</param>
+void Tournament::SetMoveStats(bool bShowMoveStats, bool bPerMoveNumber, const std::string& csvFile) {
+    t_bShowMoveStats = bShowMoveStats;
+    t_bShowMoveStatsPerMoveNumber = bPerMoveNumber;
+    t_moveStatsFile = csvFile;
+}
+
+/// <summary>
+/// Tournament::OpenMoveStatsFile() opens the per-move CSV file for appending (writing the header if the file is new)
+/// </summary>
+void Tournament::OpenMoveStatsFile(std::ofstream& csv) const {
+    if (t_moveStatsFile.empty())
+        return;
+    csv.open(t_moveStatsFile, std::ios::app);
+    if (!csv) {
+        std::cout << "Cannot open move statistics file " << t_moveStatsFile << std::endl;
+        return;
+    }
+    csv.seekp(0, std::ios::end);
+    if (csv.tellp() == 0)
+        csv << "seed,game,solver,side,move_number,time_ms,nodes" << std::endl;
+}
+
+/// <summary>
+/// Tournament::AddMoveStats() adds the moves of a game to the statistics of the match and to the per-move CSV file.  Recalled games are
+/// skipped: their moves were not searched again.
+/// </summary>
+void Tournament::AddMoveStats(MoveStats& stats, std::ofstream& csv, uint64_t matchSeed, size_t game, const GameOutcome& outcome, const std::string& red, 
+    const std::string& yellow) const {
+    if (outcome.bRecalled)
+        return;
+    for (const MoveTiming& t : outcome.timings) {
+        const std::string& solver = (t.player == RED) ? red : yellow;
+        stats.Add(solver, t.moveNumber, t.time_ms, t.nodes);
+        if (csv.is_open()) {
+            csv << matchSeed << "," << game << ",\"" << solver << "\"," << ((t.player == RED) ? "RED" : "YELLOW") << "," << t.moveNumber << "," 
+                << t.time_ms << "," << t.nodes << "\n";
+        }
+    }
+    if (csv.is_open())
+        csv.flush();
+}
+
+/// <summary>
+/// Tournament::PrintMoveStats() displays the move statistics of a match (if enabled)
+/// </summary>
+void Tournament::PrintMoveStats(const MoveStats& stats) const {
+    if (!t_bShowMoveStats || stats.IsEmpty())
+        return;
+    std::cout << std::endl;
+    stats.PrintSummary(std::cout, t_bShowMoveStatsPerMoveNumber);
+}
+
+/// <summary>
+/// Tournament::SetGameRecordFile() writes every game played from now on (moves, opening included, and result) to a compact game record file
+/// (see GameRecord.h), in game order.  The file is closed by the next call, or when the tournament ends; an empty file name closes it.
+/// </summary>
+/// <param name="filename">Game record file (overwritten; empty = none)</param>
+/// <param name="bIndex">Write a block index, so that any game can be read without reading the games before it</param>
+/// <returns>false if the file cannot be created</returns>
+bool Tournament::SetGameRecordFile(const std::string& filename, bool bIndex) {
+    t_gameRecords.Close();
+    if (filename.empty())
+        return true;
+    return t_gameRecords.Open(filename, bIndex);
+}
+
+/// <summary>
+/// Tournament::RecordGame() writes a game to the game record file (if any)
+/// </summary>
+void Tournament::RecordGame(const GameOutcome& outcome) {
+    Move moves[WIDTH * HEIGHT];
+    unsigned int nMoves = 0;
+    for (char c : outcome.moves) {
+        moves[nMoves++] = (Move)(c - '0');
+    }
+    t_gameRecords.Write(moves, nMoves, GameResultFromWinner(outcome.winner));
+}
+
+/// <summary>
+/// Tournament::SetTimeControl() sets a chess-clock time control for all games: each solver starts with baseSeconds on its clock and gets
+/// incrementSeconds after each of its moves.  A base time of 0 removes the time control (solvers search to their own depth, untimed).
+/// </summary>
+/// <param name="baseSeconds">Time on each solver's clock at the start of the game</param>
+/// <param name="incrementSeconds">Time added after each move</param>
+void Tournament::SetTimeControl(double baseSeconds, double incrementSeconds) {
+    t_baseTime_ms = 1000.0 * baseSeconds;
+    t_increment_ms = (baseSeconds > 0) ? 1000.0 * incrementSeconds : 0.0;
+}
+
+/// <summary>
+/// Tournament::HasTimeControl() returns true if games are played under a time control
+/// </summary>
+bool Tournament::HasTimeControl(void) const {
+    return t_baseTime_ms > 0;
+}
+
+//
+// Two-solver matches
+//
+
+/// <summary>
+/// Tournament::PlayTwoSolvers() allows two solvers (both derived from Solver_ConnectFour class) to play each other.  
+/// Fundamentally, each solver is presented with a board and is asked for its best move.  Solvers alternate with each move until the game is won or is drawn.
+/// Solvers do not think while it is the other solvers turn to move.  Future work is to allow solvers to think during the other player's move.
+/// Both solvers are initialized prior to this function call.
+/// With a time control (see SetTimeControl()), each solver is given its remaining time through SolveBoard() and its clock runs while it searches; 
+/// a solver that exceeds its time loses the game.
+/// </summary>
+/// <param name="p1">First Solver (to play as RED)</param>
+/// <param name="p2">Second Solver (to play as YELLOW)</param>
+/// <param name="out">Stream to which the moves and the result are written</param>
+/// <param name="opening">Moves played before the solvers take over (e.g., "4453"); the solvers play from the resulting position</param>
+/// <param name="record">If not null, returns the moves of the game (including the opening), one digit per move, and whether it was lost on time</param>
+/// <returns></returns>
+int Tournament::PlayTwoSolvers(Solver_ConnectFour* p1, Solver_ConnectFour* p2, std::ostream& out, const std::string& opening, GameOutcome* record) {
+    int winner;
+    Move m;
+    typePlayer playerToMove = RED;  // RED moves first; in this case p1 is RED, P2 is YELLOW
+    bool bTimeForfeit = false;
+
+    // Chess clocks (only used with a time control): each solver starts with the base time and gets the increment after each of its moves
+    SolverClock clock[2];
+    clock[RED].remaining_ms = clock[YELLOW].remaining_ms = t_baseTime_ms;
+    clock[RED].increment_ms = clock[YELLOW].increment_ms = t_increment_ms;
+    bool bTimed = HasTimeControl();
+
+    Board vboard; // the tournament board
+    vboard.InitBoard(playerToMove);
+
+    MoveHistory mh; // the move history
+    mh.ResetHistory();
+
+    // Play the opening moves (validated when the openings were loaded)
+    for (char c : opening) {
+        m = (Move)(c - '0');
+        vboard.MakeMove(m, playerToMove);
+        mh.AddMove(m);
+        playerToMove = (typePlayer)!playerToMove;
+    }
+    // Nothing is allocated or written while the game is played: the record is sized for the longest game, and the output is written at the end
+    if (record) {
+        record->moves.reserve(WIDTH * HEIGHT);
+        record->moves = opening;
+        record->timings.reserve(WIDTH * HEIGHT);
+    }
+
+    // Loop until there is a winner
+    for (; ; ) {
+        
+        // 1. If there are no valid moves on the board, the game is a draw
+        if (vboard.IsNoMove()) {
+            winner = 0;
+            break;
+        }
+
+        // 2. Select a Valid Move and Play it
+        Solver_ConnectFour* p = (playerToMove == RED) ? p1 : p2;
+        MoveTiming timing;
+        timing.moveNumber = mh.NumberOfMoves();
+        timing.player = playerToMove;
+        unsigned long long nodes = p->GetNumberOfNodes();
+        auto start = std::chrono::steady_clock::now();
+        if (bTimed)
+            m = p->SolveBoard(vboard, mh.NumberOfMoves(), clock[playerToMove]);
+        else
+            m = p->SolveBoard(vboard, mh.NumberOfMoves());
+        timing.time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        timing.nodes = p->GetNumberOfNodes() - nodes;
+        if (record)
+            record->timings.push_back(timing);
+
+        if (bTimed) {
+            clock[playerToMove].remaining_ms -= timing.time_ms;
+
+            // A solver whose flag falls loses the game
+            if (clock[playerToMove].remaining_ms < 0) {
+                winner = (playerToMove == RED) ? -1 : 1;
+                bTimeForfeit = true;
+                break;
+            }
+            clock[playerToMove].remaining_ms += clock[playerToMove].increment_ms;
+        }
+
+        vboard.MakeMove(m,playerToMove);
+        mh.AddMove(m);
+        if (record)
+            record->moves.push_back((char)('0' + m));
+
+
+        // 3. Check if the moving player won the game
+        if (vboard.IsWin(playerToMove)) {
+            winner = (playerToMove == RED) ? 1 : -1;
+            break;
+        }
+
+        // 4. Toggle player for the next move
+        playerToMove = (typePlayer)!playerToMove;
+    }
+
+    if (record)
+        record->bTimeForfeit = bTimeForfeit;
+
+    WriteGame(out, opening, mh, winner, bTimeForfeit);
+    return winner;
+}
+
+/// <summary>
+/// Tournament::WriteGame() writes the moves and the result of a game, as enabled by SetDisplay()
+/// </summary>
+/// <param name="out">Stream to write to</param>
+/// <param name="opening">Moves played before the solvers took over</param>
+/// <param name="mh">Moves of the game, including the opening</param>
+/// <param name="winner">1 = RED won, -1 = YELLOW won, 0 = draw</param>
+/// <param name="bTimeForfeit">The loser exceeded its time</param>
+void Tournament::WriteGame(std::ostream& out, const std::string& opening, MoveHistory& mh, int winner, bool bTimeForfeit) const {
+    if (t_bShowMoveByMove) {
+        if (!opening.empty())
+            out << "(" << opening << ") ";
+        for (unsigned int i = (unsigned int)opening.size(); i < mh.NumberOfMoves(); i++) {
+            out << mh.GetMove(i) << " ";
+        }
+    }
+
+    if (t_bShowWinner) {
+        if (bTimeForfeit)
+            out << " TIME FORFEIT!";
+        switch (winner) {
+        case 1:
+            out << " RED WINS! \n";
+            break;
+        case -1:
+            out << " YELLOW WINS! \n";
+            break;
+        default:
+            out << " DRAW! \n";
+            break;
+        }
+    }
+    
+    if (t_bShowMoveHistory)
+        mh.PrintMoveHistory(out);
+}
+
+/// <summary>
+/// Tournament::PlayOrRecallGame() plays one game of a match.  If both solvers are deterministic, the game only depends on the two solver configurations and 
+/// the starting position, so its outcome is stored and any later request for the same game in the match is answered from the cache.
+/// A recalled game keeps the opening requested: another opening may have transposed to the same position.
+/// </summary>
+/// <param name="pRed">Solver playing RED</param>
+/// <param name="pYellow">Solver playing YELLOW</param>
+/// <param name="opening">Moves played before the solvers take over</param>
+/// <param name="matchSeed">Seed of the match</param>
+/// <param name="game">Game number within the match</param>
+/// <param name="CachedGames">Incremented if the outcome was recalled rather than played</param>
+/// <returns>Outcome of the game</returns>
+GameOutcome Tournament::PlayOrRecallGame(Solver_ConnectFour* pRed, Solver_ConnectFour* pYellow, const std::string& opening, uint64_t matchSeed, unsigned int game, std::atomic<unsigned long>& CachedGames) {
+    auto play = [&]() {
+        std::ostringstream out;
+        pRed->SeedRandom(matchSeed, game, RED);
+        pYellow->SeedRandom(matchSeed, game, YELLOW);
+        GameOutcome outcome;
+        outcome.winner = PlayTwoSolvers(pRed, pYellow, out, opening, &outcome);
+        outcome.text = out.str();
+        return outcome;
+    };
+
+    // Under a time control, a solver's moves depend on the time its searches take, so no game is ever replayed identically
+    if (!pRed->IsDeterministic() || !pYellow->IsDeterministic() || HasTimeControl())
+        return play();
+
+    Board start;
+    Board::FromMoves(opening, start);
+    std::string key = pRed->GetFingerprint() + "|" + pYellow->GetFingerprint() + "|" + 
+        std::to_string(start.GetBoard(RED)) + ":" + std::to_string(start.GetBoard(YELLOW)) + ":" + std::to_string(start.GetPlayerToMove());
+
+    std::promise<t_CachedGame> promise;
+    std::shared_future<t_CachedGame> future;
+    {
+        std::lock_guard<std::mutex> lock(t_gameCacheMutex);
+        auto it = t_gameCache.find(key);
+        if (it != t_gameCache.end()) {
+            future = it->second;
+        }
+        else {
+            t_gameCache[key] = promise.get_future().share();
+        }
+    }
+
+    if (future.valid()) {
+        CachedGames++;
+        const t_CachedGame& cached = future.get();
+        GameOutcome outcome;
+        outcome.winner = cached.winner;
+        outcome.bRecalled = true;
+        outcome.moves = opening + cached.moves;
+        MoveHistory mh;
+        mh.ResetHistory();
+        for (char c : outcome.moves)
+            mh.AddMove((Move)(c - '0'));
+        std::ostringstream out;
+        WriteGame(out, opening, mh, outcome.winner, false);
+        outcome.text = out.str();
+        return outcome;
+    }
+
+    GameOutcome outcome = play();
+    promise.set_value(t_CachedGame{ outcome.winner, outcome.moves.substr(opening.size()) });
+    return outcome;
+}
+
+/// <summary>
+/// Tournament::ClearGameCache() forgets the games of the match that has ended
+/// </summary>
+void Tournament::ClearGameCache(void) {
+    std::lock_guard<std::mutex> lock(t_gameCacheMutex);
+    t_gameCache.clear();
+}
+
+/// <summary>
+/// MoveStatsNames() returns the names under which the moves of two solvers are collected: their fingerprints, numbered if they are the same
+/// </summary>
+static void MoveStatsNames(Solver_ConnectFour* p1, Solver_ConnectFour* p2, std::string& name1, std::string& name2) {
+    name1 = p1->GetFingerprint();
+    name2 = p2->GetFingerprint();
+    if (name1 == name2) {
+        name1 += " #1";
+        name2 += " #2";
+    }
+}
+
+/// <summary>
+/// Tournament::MatchPlay() allows two solvers (both derived from Solver_ConnectFour class) to play each other for a specified number of games. 
+/// The games are played concurrently on a pool of worker threads; each worker plays with its own clones of the two solvers.
+/// The output of each game is collected and displayed in game order, so the output does not depend on the number of threads.
+/// </summary>
+/// <param name="p1">First Solver (to play as RED)</param>
+/// <param name="p2">Second Solver (to play as YELLOW)</param>
+/// <param name="numberOfGames">Number of Games to be Played</param>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread)</param>
+/// <param name="matchSeed">Seed of the match; every game seeds both solvers from (matchSeed, game number, side).  0 = seed from the clock</param>
+void Tournament::MatchPlay(Solver_ConnectFour* p1, Solver_ConnectFour* p2, unsigned int numberOfGames, unsigned int nThreads, uint64_t matchSeed) {
+    std::atomic<unsigned long> NumGames(0), RedWins(0), YellowWins(0), Draw(0), CachedGames(0), TimeForfeits(0);
+
+    if (matchSeed == 0)
+        matchSeed = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+
+    if (nThreads == 0)
+        nThreads = DefaultNumberOfThreads();
+    if (nThreads > numberOfGames)
+        nThreads = (numberOfGames == 0) ? 1 : numberOfGames;
+
+    // Each worker thread gets its own solvers (with one thread, the solvers passed in are used, unless they are the same solver: each side then
+    // needs its own, as each side's random number generator is seeded for the game)
+    bool bClones = (nThreads > 1) || (p1 == p2);
+    std::vector<std::unique_ptr<Solver_ConnectFour>> red, yellow;
+    for (unsigned int w = 0; (w < nThreads) && bClones; w++) {
+        red.emplace_back(p1->Clone());
+        yellow.emplace_back(p2->Clone());
+    }
+
+    MoveStats stats;
+    std::ofstream csv;
+    OpenMoveStatsFile(csv);
+    std::string redName, yellowName;
+    MoveStatsNames(p1, p2, redName, yellowName);
+
+    unsigned int nextGame = 0;
+    RunOrdered<unsigned int, GameOutcome>(nThreads, 4 * (size_t)nThreads,
+        // next game to be played
+        [&](unsigned int& game) {
+            if (nextGame >= numberOfGames)
+                return false;
+            game = nextGame++;
+            return true;
+        },
+        // play the game on worker w
+        [&](unsigned int w, unsigned int& game) {
+            Solver_ConnectFour* pRed = bClones ? red[w].get() : p1;
+            Solver_ConnectFour* pYellow = bClones ? yellow[w].get() : p2;
+            GameOutcome outcome = PlayOrRecallGame(pRed, pYellow, "", matchSeed, game, CachedGames);
+            NumGames++;
+            if (outcome.bTimeForfeit)
+                TimeForfeits++;
+            switch (outcome.winner) {
+            case 1:
+                RedWins++;
+                break;
+            case -1:
+                YellowWins++;
+                break;
+            case 0:
+                Draw++;
+                break;
+            default:
+                break;
+            }
+            return outcome;
+        },
+        // display the games in order
+        [&](size_t game, GameOutcome& outcome) {
+            if (t_bShowGameNumber)
+                std::cout << "[ " << game << " ] ";
+            std::cout << outcome.text;
+            AddMoveStats(stats, csv, matchSeed, game, outcome, redName, yellowName);
+            RecordGame(outcome);
+            return true;
+        });
+    ClearGameCache();
+
+    std::cout << std::endl;
+    std::cout << "Match Seed: " << matchSeed << std::endl;
+    std::cout << "Number of Games: " << NumGames << std::endl;
+    std::cout << "Number of Red Wins: " << RedWins << std::endl;
+    std::cout << "Number of Yellow Wins: " << YellowWins << std::endl;
+    std::cout << "Number of Draws: " << Draw << std::endl;
+    if (HasTimeControl())
+        std::cout << "Number of Games Lost on Time: " << TimeForfeits << std::endl;
+    if (CachedGames != 0)
+        std::cout << "Number of Games Recalled (deterministic solvers): " << CachedGames << std::endl;
+
+    // Root search caches (clones share the cache of the solver they were cloned from)
+    Solver_ConnectFour* solvers[] = { p1, p2 };
+    for (Solver_ConnectFour* p : solvers) {
+        std::shared_ptr<SolveCache> cache = p->GetSolveCache();
+        if (cache)
+            std::cout << p->GetPlayerName() << " Search Cache Hits / Misses: " << cache->GetHits() << " / " << cache->GetMisses() << std::endl;
+    }
+
+    PrintMoveStats(stats);
+}
+
+/// <summary>
+/// Tournament::LoadOpenings() reads an opening suite: one opening per line, written as a sequence of moves (e.g., "4453").  Blank lines and lines starting 
+/// with '#' are ignored; openings that are not valid (or are already won) are reported and skipped.
+/// </summary>
+/// <param name="filename">Opening suite file</param>
+/// <param name="openings">Returns the openings</param>
+/// <returns>true if the file could be read</returns>
+bool Tournament::LoadOpenings(const std::string& filename, std::vector<std::string>& openings) {
+    std::ifstream in(filename);
+    if (!in) {
+        std::cout << "Cannot open opening suite " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        while (!line.empty() && ((line.back() == '\r') || (line.back() == ' ') || (line.back() == '\t')))
+            line.pop_back();
+        if (line.empty() || (line[0] == '#'))
+            continue;
+
+        Board b;
+        if (!Board::FromMoves(line, b) || b.IsNoMove() || b.IsWin((typePlayer)!b.GetPlayerToMove())) {
+            std::cout << "Skipping opening on line " << lineNumber << ": " << line << std::endl;
+            continue;
+        }
+        openings.push_back(line);
+    }
+    return true;
+}
+
+/// <summary>
+/// Tournament::OpeningMatchPlay() plays two solvers against each other from every opening of an opening suite, once with each solver as RED (colours swapped).
+/// Every game is distinct, even between deterministic solvers, and the games are played concurrently on a pool of worker threads.
+/// The results are displayed per opening, from the point of view of the first solver.
+/// </summary>
+/// <param name="p1">First Solver</param>
+/// <param name="p2">Second Solver</param>
+/// <param name="openings">Opening suite (see LoadOpenings())</param>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread)</param>
+/// <param name="matchSeed">Seed of the match (0 = seed from the clock)</param>
+void Tournament::OpeningMatchPlay(Solver_ConnectFour* p1, Solver_ConnectFour* p2, const std::vector<std::string>& openings, unsigned int nThreads, uint64_t matchSeed) {
+    struct OpeningResult {
+        unsigned int wins = 0, draws = 0, losses = 0;	// for p1
+    };
+    std::vector<OpeningResult> results(openings.size());
+    std::atomic<unsigned long> CachedGames(0);
+    unsigned int timeForfeits = 0;
+    unsigned int numberOfGames = 2 * (unsigned int)openings.size();
+
+    if (matchSeed == 0)
+        matchSeed = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    if (nThreads == 0)
+        nThreads = DefaultNumberOfThreads();
+    if (nThreads > numberOfGames)
+        nThreads = (numberOfGames == 0) ? 1 : numberOfGames;
+
+    // Each worker thread gets its own solvers (with one thread, the solvers passed in are used, unless they are the same solver: each side then
+    // needs its own, as each side's random number generator is seeded for the game)
+    bool bClones = (nThreads > 1) || (p1 == p2);
+    std::vector<std::unique_ptr<Solver_ConnectFour>> first, second;
+    for (unsigned int w = 0; (w < nThreads) && bClones; w++) {
+        first.emplace_back(p1->Clone());
+        second.emplace_back(p2->Clone());
+    }
+
+    MoveStats stats;
+    std::ofstream csv;
+    OpenMoveStatsFile(csv);
+    std::string name1, name2;
+    MoveStatsNames(p1, p2, name1, name2);
+
+    unsigned int nextGame = 0;
+    RunOrdered<unsigned int, GameOutcome>(nThreads, 4 * (size_t)nThreads,
+        // next game: games 2k and 2k+1 are opening k, with p1 as RED and then p2 as RED
+        [&](unsigned int& game) {
+            if (nextGame >= numberOfGames)
+                return false;
+            game = nextGame++;
+            return true;
+        },
+        [&](unsigned int w, unsigned int& game) {
+            Solver_ConnectFour* a = bClones ? first[w].get() : p1;
+            Solver_ConnectFour* b = bClones ? second[w].get() : p2;
+            bool bSwapped = (game % 2) == 1;
+            return PlayOrRecallGame(bSwapped ? b : a, bSwapped ? a : b, openings[game / 2], matchSeed, game, CachedGames);
+        },
+        [&](size_t game, GameOutcome& outcome) {
+            bool bSwapped = (game % 2) == 1;
+            int p1Result = bSwapped ? -outcome.winner : outcome.winner;
+            OpeningResult& r = results[game / 2];
+            if (p1Result > 0)
+                r.wins++;
+            else if (p1Result < 0)
+                r.losses++;
+            else
+                r.draws++;
+            if (outcome.bTimeForfeit)
+                timeForfeits++;
+
+            if (t_bShowGameNumber)
+                std::cout << "[ " << game << " ] ";
+            std::cout << outcome.text;
+            AddMoveStats(stats, csv, matchSeed, game, outcome, bSwapped ? name2 : name1, bSwapped ? name1 : name2);
+            RecordGame(outcome);
+            return true;
+        });
+    ClearGameCache();
+
+    // Display the results per opening (from p1's point of view)
+    unsigned int wins = 0, draws = 0, losses = 0;
+    std::cout << std::endl << p1->GetPlayerName() << " vs. " << p2->GetPlayerName() << std::endl;
+    std::cout << std::left << std::setw(16) << "Opening" << " W  D  L" << std::endl;
+    for (size_t k = 0; k < openings.size(); k++) {
+        const OpeningResult& r = results[k];
+        std::cout << std::left << std::setw(16) << openings[k] << " " << r.wins << "  " << r.draws << "  " << r.losses << std::endl;
+        wins += r.wins;
+        draws += r.draws;
+        losses += r.losses;
+    }
+    std::cout << std::right;
+
+    std::cout << std::endl;
+    std::cout << "Match Seed: " << matchSeed << std::endl;
+    std::cout << "Number of Openings: " << openings.size() << std::endl;
+    std::cout << "Number of Games: " << numberOfGames << std::endl;
+    std::cout << "Number of Wins / Draws / Losses (" << p1->GetPlayerName() << "): " << wins << " / " << draws << " / " << losses << std::endl;
+    if (HasTimeControl())
+        std::cout << "Number of Games Lost on Time: " << timeForfeits << std::endl;
+    if (CachedGames != 0)
+        std::cout << "Number of Games Recalled (deterministic solvers): " << CachedGames << std::endl;
+
+    PrintMoveStats(stats);
+}
+
+/// <summary>
+/// Tournament::SPRTMatchPlay() plays p1 against p2 until a sequential probability ratio test decides whether p1 is stronger (H1) or not (H0), or until
+/// maxGames have been played.  Colours alternate every game; with an opening suite, each pair of games plays the next opening with colours swapped.
+/// The games are played concurrently, but the test is updated in game order, so the decision (and the game at which it is made) does not depend on 
+/// the number of threads.  Games already started when the test stops are discarded.
+/// Only games actually played are evidence: a game recalled from the game cache repeats one already counted, so it is not added to the test.
+/// Two deterministic solvers can only play two distinct games per opening (one with each colour), so the match then stops after those games.
+/// </summary>
+/// <param name="p1">Solver being tested</param>
+/// <param name="p2">Reference solver</param>
+/// <param name="test">Test to run (Elo bounds, alpha and beta)</param>
+/// <param name="maxGames">Maximum number of games</param>
+/// <param name="openings">Opening suite (may be empty: all games start from the empty board)</param>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread)</param>
+/// <param name="matchSeed">Seed of the match (0 = seed from the clock)</param>
+/// <returns>Status of the test</returns>
+t_SPRTStatus Tournament::SPRTMatchPlay(Solver_ConnectFour* p1, Solver_ConnectFour* p2, SPRT test, unsigned int maxGames, const std::vector<std::string>& openings, 
+    unsigned int nThreads, uint64_t matchSeed) {
+    std::atomic<unsigned long> CachedGames(0);
+    t_SPRTStatus status = SPRT_CONTINUE;
+
+    if (matchSeed == 0)
+        matchSeed = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    if (nThreads == 0)
+        nThreads = DefaultNumberOfThreads();
+    if (nThreads > maxGames)
+        nThreads = (maxGames == 0) ? 1 : maxGames;
+
+    // Each worker thread gets its own solvers (with one thread, the solvers passed in are used, unless they are the same solver: each side then
+    // needs its own, as each side's random number generator is seeded for the game)
+    bool bClones = (nThreads > 1) || (p1 == p2);
+    std::vector<std::unique_ptr<Solver_ConnectFour>> first, second;
+    for (unsigned int w = 0; (w < nThreads) && bClones; w++) {
+        first.emplace_back(p1->Clone());
+        second.emplace_back(p2->Clone());
+    }
+
+    MoveStats stats;
+    std::ofstream csv;
+    OpenMoveStatsFile(csv);
+    std::string name1, name2;
+    MoveStatsNames(p1, p2, name1, name2);
+
+    // Deterministic solvers replay the same game for the same opening and colours: beyond that, there is no new evidence
+    if (p1->IsDeterministic() && p2->IsDeterministic() && !HasTimeControl()) {
+        unsigned int distinctGames = 2 * (unsigned int)std::max<size_t>(openings.size(), 1);
+        if (maxGames > distinctGames) {
+            std::cout << "SPRT: both solvers are deterministic, so only " << distinctGames << " distinct games can be played (two per opening); "
+                << "the match stops after " << distinctGames << " games" << std::endl;
+            maxGames = distinctGames;
+        }
+    }
+
+    std::cout << "SPRT: LLR bounds [" << test.GetLowerBound() << ", " << test.GetUpperBound() << "]" << std::endl;
+
+    unsigned int nextGame = 0, recalledGames = 0;
+    RunOrdered<unsigned int, GameOutcome>(nThreads, 2 * (size_t)nThreads,
+        [&](unsigned int& game) {
+            if (nextGame >= maxGames)
+                return false;
+            game = nextGame++;
+            return true;
+        },
+        [&](unsigned int w, unsigned int& game) {
+            Solver_ConnectFour* a = bClones ? first[w].get() : p1;
+            Solver_ConnectFour* b = bClones ? second[w].get() : p2;
+            bool bSwapped = (game % 2) == 1;
+            const std::string& opening = openings.empty() ? std::string() : openings[(game / 2) % openings.size()];
+            return PlayOrRecallGame(bSwapped ? b : a, bSwapped ? a : b, opening, matchSeed, game, CachedGames);
+        },
+        [&](size_t game, GameOutcome& outcome) {
+            bool bSwapped = (game % 2) == 1;
+            if (!outcome.bRecalled)
+                status = test.AddResult(bSwapped ? -outcome.winner : outcome.winner);
+            else
+                recalledGames++;
+            AddMoveStats(stats, csv, matchSeed, game, outcome, bSwapped ? name2 : name1, bSwapped ? name1 : name2);
+            RecordGame(outcome);
+
+            // The LLR trajectory: one value per game
+            if (t_bShowGameNumber)
+                std::cout << "[ " << game << " ] ";
+            std::string text = outcome.text;
+            while (!text.empty() && (text.back() == '\n'))
+                text.pop_back();
+            std::cout << text << " LLR " << test.LLR() << (outcome.bRecalled ? " (recalled: not counted)" : "") << std::endl;
+
+            return status == SPRT_CONTINUE;
+        });
+    ClearGameCache();
+
+    std::cout << std::endl;
+    std::cout << "Match Seed: " << matchSeed << std::endl;
+    std::cout << "Number of Games: " << test.NumberOfGames() << std::endl;
+    if (recalledGames != 0)
+        std::cout << "Number of Games Recalled (not counted): " << recalledGames << std::endl;
+    std::cout << "LLR: " << test.LLR() << " [" << test.GetLowerBound() << ", " << test.GetUpperBound() << "]" << std::endl;
+    std::cout << "SPRT Result: " << SPRT::StatusName(status) << std::endl;
+
+    PrintMoveStats(stats);
+    return status;
+}
+
+
+//
+// Multi-solver tournaments
+//
+
+/// <summary>
+/// Tournament::AddSolver() adds a solver (configuration) to the tournament; solvers are numbered in the order they are added, from 0
+/// </summary>
+void Tournament::AddSolver(Solver_ConnectFour* p) {
+    t_solvers.push_back(p);
+}
+
+/// <summary>
+/// Tournament::SetOpenings() sets the opening suite of RoundRobin() and Gauntlet(); each pair of games between two solvers plays the next opening,
+/// once with each solver as RED.  Without openings, all games start from the empty board.
+/// </summary>
+void Tournament::SetOpenings(const std::vector<std::string>& openings) {
+    t_openings = openings;
+}
+
+/// <summary>
+/// Tournament::SetResultsFile() streams the result of every game of RoundRobin() and Gauntlet() to a file, one line per game, as soon as the game
+/// is played (so a long tournament can be followed, and a tournament that is stopped keeps its games).  The final ratings are written to the 
+/// same file name followed by ".ratings".
+/// </summary>
+/// <param name="filename">Results file (empty = no file)</param>
+/// <param name="format">RESULTS_CSV (one header line, then one line per game) or RESULTS_JSON (one JSON object per line)</param>
+void Tournament::SetResultsFile(const std::string& filename, t_ResultsFormat format) {
+    t_resultsFile = filename;
+    t_resultsFormat = format;
+}
+
+/// <summary>
+/// Tournament::RoundRobin() plays every solver against every other solver
+/// </summary>
+/// <param name="gamesPerPair">Number of games between each pair of solvers (colours alternate)</param>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread)</param>
+/// <param name="matchSeed">Seed of the tournament (0 = seed from the clock)</param>
+void Tournament::RoundRobin(unsigned int gamesPerPair, unsigned int nThreads, uint64_t matchSeed) {
+    std::vector<std::pair<unsigned int, unsigned int>> pairings;
+    for (unsigned int i = 0; i < t_solvers.size(); i++) {
+        for (unsigned int j = i + 1; j < t_solvers.size(); j++)
+            pairings.push_back(std::make_pair(i, j));
+    }
+    PlayPairings(pairings, gamesPerPair, nThreads, matchSeed);
+}
+
+/// <summary>
+/// Tournament::Gauntlet() plays the first solver added against every other solver (the other solvers do not play each other)
+/// </summary>
+/// <param name="gamesPerPair">Number of games between the first solver and each other solver (colours alternate)</param>
+/// <param name="nThreads">Number of worker threads (0 = one per hardware thread)</param>
+/// <param name="matchSeed">Seed of the tournament (0 = seed from the clock)</param>
+void Tournament::Gauntlet(unsigned int gamesPerPair, unsigned int nThreads, uint64_t matchSeed) {
+    std::vector<std::pair<unsigned int, unsigned int>> pairings;
+    for (unsigned int j = 1; j < t_solvers.size(); j++)
+        pairings.push_back(std::make_pair(0u, j));
+    PlayPairings(pairings, gamesPerPair, nThreads, matchSeed);
+}
+
+/// <summary>
+/// QuoteCSV() / QuoteJSON() quote a string for the results file
+/// </summary>
+static std::string QuoteCSV(const std::string& s) {
+    std::string q = "\"";
+    for (char c : s) {
+        if (c == '"')
+            q += '"';
+        q += c;
+    }
+    return q + "\"";
+}
+
+static std::string QuoteJSON(const std::string& s) {
+    std::string q = "\"";
+    for (char c : s) {
+        if ((c == '"') || (c == '\\'))
+            q += '\\';
+        q += c;
+    }
+    return q + "\"";
+}
+
+/// <summary>
+/// Tournament::PlayPairings() plays gamesPerPair games for each pairing of solvers, all on one pool of worker threads, then displays the 
+/// Elo ratings of the solvers.  Game g is game (g % gamesPerPair) of pairing (g / gamesPerPair); odd games swap the colours, and each pair of
+/// games plays the next opening of the suite.  Results are streamed to the results file in game order.  Games recalled from an earlier
+/// identical game of deterministic solvers are not counted in the ratings, since they carry no new evidence.
+/// </summary>
+void Tournament::PlayPairings(const std::vector<std::pair<unsigned int, unsigned int>>& pairings, unsigned int gamesPerPair, unsigned int nThreads, uint64_t matchSeed) {
+    const unsigned int nSolvers = (unsigned int)t_solvers.size();
+    const unsigned int numberOfGames = (unsigned int)pairings.size() * gamesPerPair;
+    std::atomic<unsigned long> CachedGames(0);
+    EloRating rating(nSolvers);
+    std::vector<unsigned int> timeForfeits(nSolvers, 0);
+
+    if (matchSeed == 0)
+        matchSeed = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+    if (nThreads == 0)
+        nThreads = DefaultNumberOfThreads();
+    if (nThreads > numberOfGames)
+        nThreads = (numberOfGames == 0) ? 1 : numberOfGames;
+
+    // Each worker thread gets its own solvers (with one thread, the solvers added are used, unless a solver was added twice: each side of a 
+    // game then needs its own, as each side's random number generator is seeded for the game)
+    bool bClones = (nThreads > 1);
+    for (unsigned int i = 0; i < nSolvers; i++) {
+        for (unsigned int j = i + 1; j < nSolvers; j++)
+            bClones = bClones || (t_solvers[i] == t_solvers[j]);
+    }
+    std::vector<std::vector<std::unique_ptr<Solver_ConnectFour>>> clones(nThreads);
+    for (unsigned int w = 0; (w < nThreads) && bClones; w++) {
+        for (Solver_ConnectFour* p : t_solvers)
+            clones[w].emplace_back(p->Clone());
+    }
+
+    std::vector<std::string> names;
+    for (Solver_ConnectFour* p : t_solvers)
+        names.push_back(p->GetFingerprint());
+
+    // Deterministic solvers replay the same game for the same opening and colours: beyond that, the games only repeat
+    unsigned int distinctGames = 2 * (unsigned int)std::max<size_t>(t_openings.size(), 1);
+    if ((gamesPerPair > distinctGames) && !HasTimeControl()) {
+        for (const std::pair<unsigned int, unsigned int>& pairing : pairings) {
+            if (t_solvers[pairing.first]->IsDeterministic() && t_solvers[pairing.second]->IsDeterministic()) {
+                std::cout << "Warning: " << names[pairing.first] << " and " << names[pairing.second] << " are deterministic, so only " 
+                    << distinctGames << " of their " << gamesPerPair << " games are distinct (two per opening); repeated games are not rated" << std::endl;
+            }
+        }
+    }
+
+    MoveStats stats;
+    std::ofstream csv;
+    OpenMoveStatsFile(csv);
+    std::vector<std::string> labels;
+    for (unsigned int i = 0; i < nSolvers; i++)
+        labels.push_back(std::to_string(i) + ": " + names[i]);
+
+    std::ofstream results;
+    if (!t_resultsFile.empty()) {
+        results.open(t_resultsFile);
+        if (!results)
+            std::cout << "Cannot open results file " << t_resultsFile << std::endl;
+        else if (t_resultsFormat == RESULTS_CSV)
+            results << "game,red_id,red,yellow_id,yellow,opening,result,termination,moves" << std::endl;
+    }
+
+    unsigned int nextGame = 0;
+    RunOrdered<unsigned int, GameOutcome>(nThreads, 4 * (size_t)nThreads,
+        [&](unsigned int& game) {
+            if (nextGame >= numberOfGames)
+                return false;
+            game = nextGame++;
+            return true;
+        },
+        [&](unsigned int w, unsigned int& game) {
+            const std::pair<unsigned int, unsigned int>& pairing = pairings[game / gamesPerPair];
+            unsigned int k = game % gamesPerPair;
+            bool bSwapped = (k % 2) == 1;
+            unsigned int red = bSwapped ? pairing.second : pairing.first;
+            unsigned int yellow = bSwapped ? pairing.first : pairing.second;
+            Solver_ConnectFour* pRed = bClones ? clones[w][red].get() : t_solvers[red];
+            Solver_ConnectFour* pYellow = bClones ? clones[w][yellow].get() : t_solvers[yellow];
+            const std::string& opening = t_openings.empty() ? std::string() : t_openings[(k / 2) % t_openings.size()];
+            return PlayOrRecallGame(pRed, pYellow, opening, matchSeed, game, CachedGames);
+        },
+        [&](size_t game, GameOutcome& outcome) {
+            const std::pair<unsigned int, unsigned int>& pairing = pairings[game / gamesPerPair];
+            unsigned int k = (unsigned int)(game % gamesPerPair);
+            bool bSwapped = (k % 2) == 1;
+            unsigned int red = bSwapped ? pairing.second : pairing.first;
+            unsigned int yellow = bSwapped ? pairing.first : pairing.second;
+            const std::string& opening = t_openings.empty() ? std::string() : t_openings[(k / 2) % t_openings.size()];
+            if (!outcome.bRecalled)
+                rating.AddResult(red, yellow, outcome.winner);
+            if (outcome.bTimeForfeit)
+                timeForfeits[(outcome.winner > 0) ? yellow : red]++;
+
+            AddMoveStats(stats, csv, matchSeed, game, outcome, labels[red], labels[yellow]);
+            RecordGame(outcome);
+
+            if (!outcome.text.empty()) {
+                if (t_bShowGameNumber)
+                    std::cout << "[ " << game << " ] ";
+                std::cout << names[red] << " - " << names[yellow] << ": " << outcome.text;
+            }
+
+            if (results) {
+                const char* result = (outcome.winner > 0) ? "1-0" : ((outcome.winner < 0) ? "0-1" : "1/2-1/2");
+                const char* termination = outcome.bTimeForfeit ? "time" : "normal";
+                if (t_resultsFormat == RESULTS_CSV) {
+                    results << game << "," << red << "," << QuoteCSV(names[red]) << "," << yellow << "," << QuoteCSV(names[yellow]) << "," 
+                        << opening << "," << result << "," << termination << "," << outcome.moves << std::endl;
+                }
+                else {
+                    results << "{\"game\":" << game << ",\"red_id\":" << red << ",\"red\":" << QuoteJSON(names[red]) << ",\"yellow_id\":" << yellow
+                        << ",\"yellow\":" << QuoteJSON(names[yellow]) << ",\"opening\":\"" << opening << "\",\"result\":\"" << result 
+                        << "\",\"termination\":\"" << termination << "\",\"moves\":\"" << outcome.moves << "\"}" << std::endl;
+                }
+            }
+            return true;
+        });
+    ClearGameCache();
+
+    // Ratings, strongest first
+    std::vector<double> elo, error95;
+    bool bConnected = rating.Compute(elo, error95);
+    std::vector<unsigned int> order;
+    for (unsigned int i = 0; i < nSolvers; i++)
+        order.push_back(i);
+    std::stable_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) { return elo[a] > elo[b]; });
+
+    std::cout << std::endl;
+    std::cout << "Match Seed: " << matchSeed << std::endl;
+    std::cout << "Number of Solvers: " << nSolvers << std::endl;
+    std::cout << "Number of Games: " << numberOfGames << std::endl;
+    if (CachedGames != 0)
+        std::cout << "Number of Games Recalled (not rated): " << CachedGames << std::endl;
+    if (HasTimeControl()) {
+        std::cout << "Games Lost on Time:";
+        for (unsigned int i = 0; i < nSolvers; i++)
+            std::cout << " " << i << ": " << timeForfeits[i];
+        std::cout << std::endl;
+    }
+    if (!bConnected)
+        std::cout << "Solvers not connected by games: ratings are only comparable within a group, no error bars" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::right << std::setw(4) << "Rank" << "  " << std::left << std::setw(32) << "Solver" << std::right << std::setw(8) << "Elo" 
+        << std::setw(8) << "+/-" << std::setw(8) << "Games" << std::setw(8) << "Score" << std::endl;
+    for (unsigned int r = 0; r < nSolvers; r++) {
+        unsigned int i = order[r];
+        double games = rating.GetGames(i);
+        double score = (games > 0) ? 100.0 * rating.GetScore(i) / games : 0.0;
+        std::cout << std::setw(4) << (r + 1) << "  " << std::left << std::setw(32) << labels[i] << std::right << std::fixed 
+            << std::setprecision(0) << std::setw(8) << elo[i];
+        if (bConnected)
+            std::cout << std::setw(8) << error95[i];
+        else
+            std::cout << std::setw(8) << "-";
+        std::cout << std::setw(8) << games 
+            << std::setprecision(1) << std::setw(7) << score << "%" << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+
+    PrintMoveStats(stats);
+
+    if (results) {
+        std::ofstream ratings(t_resultsFile + ".ratings");
+        if (t_resultsFormat == RESULTS_CSV)
+            ratings << "rank,id,solver,elo,error95,games,score" << std::endl;
+        for (unsigned int r = 0; r < nSolvers; r++) {
+            unsigned int i = order[r];
+            if (t_resultsFormat == RESULTS_CSV) {
+                ratings << (r + 1) << "," << i << "," << QuoteCSV(names[i]) << "," << elo[i] << ",";
+                if (bConnected)
+                    ratings << error95[i];
+                ratings << "," << rating.GetGames(i) << "," << rating.GetScore(i) << std::endl;
+            }
+            else {
+                ratings << "{\"rank\":" << (r + 1) << ",\"id\":" << i << ",\"solver\":" << QuoteJSON(names[i]) << ",\"elo\":" << elo[i] << ",\"error95\":";
+                if (bConnected)
+                    ratings << error95[i];
+                else
+                    ratings << "null";
+                ratings << ",\"games\":" << rating.GetGames(i) << ",\"score\":" << rating.GetScore(i) << "}" << std::endl;
+            }
+        }
+    }
+}
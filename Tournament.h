@@ -0,0 +1,124 @@
+/*
+  MyConnectFour, multiple solvers developed under C++
+
+  MyConnectFour is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  MyConnectFour is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <future>
+#include <atomic>
+#include <fstream>
+#include "Solver_ConnectFour.h"
+#include "SPRT.h"
+#include "MoveStats.h"
+#include "GameRecord.h"
+
+/// <summary>
+/// GameOutcome is the result of one game of a match: the winner, the moves (including the opening) and the text displayed for the game
+/// </summary>
+struct GameOutcome {
+	int winner = 0;
+	bool bTimeForfeit = false;	// the loser exceeded its time
+	bool bRecalled = false;		// the game was not played, but recalled from an identical game (it has no timings)
+	std::string moves;
+	std::string text;
+	std::vector<MoveTiming> timings;	// one per move played by the solvers
+};
+
+enum t_ResultsFormat { RESULTS_CSV = 0, RESULTS_JSON = 1 };
+
+/// <summary>
+/// Tournament plays Connect Four solvers (all derived from Solver_ConnectFour) against each other: two-solver matches (MatchPlay, 
+/// OpeningMatchPlay, SPRTMatchPlay) and multi-solver round-robins and gauntlets with Elo ratings (RoundRobin, Gauntlet).
+/// Games are played concurrently on a pool of worker threads, each worker playing with its own clones of the solvers; the output of each game 
+/// is collected and displayed in game order, so the output does not depend on the number of threads.
+/// The solvers added to a tournament are owned by the caller and must outlive it.
+/// </summary>
+class Tournament
+{
+private:
+	// Display settings
+	bool t_bShowWinner;
+	bool t_bShowMoveByMove;
+	bool t_bShowMoveHistory;
+	bool t_bShowGameNumber;
+	bool t_bShowMoveStats;
+	bool t_bShowMoveStatsPerMoveNumber;
+	std::string t_moveStatsFile;
+	GameRecordWriter t_gameRecords;	// every game played, in game order (see SetGameRecordFile())
+
+	// Multi-solver tournaments
+	std::vector<Solver_ConnectFour*> t_solvers;
+	std::vector<std::string> t_openings;
+	std::string t_resultsFile;
+	t_ResultsFormat t_resultsFormat;
+
+	// Time control (0 = none), in milliseconds
+	double t_baseTime_ms;
+	double t_increment_ms;
+
+	// Outcomes of games between deterministic solvers within a match, keyed by (fingerprint of RED, fingerprint of YELLOW, starting position).
+	// Only the winner and the moves played by the solvers are kept: openings that transpose to the same position share an entry, so a recalled
+	// game is rebuilt with its own opening.  A game being played is stored as a future, so concurrent requests for the same game wait for it 
+	// instead of playing it again.  The cache is cleared at the end of each match.
+	struct t_CachedGame {
+		int winner;
+		std::string moves;	// after the opening
+	};
+	std::mutex t_gameCacheMutex;
+	std::map<std::string, std::shared_future<t_CachedGame>> t_gameCache;
+
+	GameOutcome PlayOrRecallGame(Solver_ConnectFour* pRed, Solver_ConnectFour* pYellow, const std::string& opening, uint64_t matchSeed, unsigned int game, 
+		std::atomic<unsigned long>& CachedGames);
+	void ClearGameCache(void);
+	void WriteGame(std::ostream& out, const std::string& opening, MoveHistory& mh, int winner, bool bTimeForfeit) const;
+	void OpenMoveStatsFile(std::ofstream& csv) const;
+	void AddMoveStats(MoveStats& stats, std::ofstream& csv, uint64_t matchSeed, size_t game, const GameOutcome& outcome, const std::string& red, 
+		const std::string& yellow) const;
+	void PrintMoveStats(const MoveStats& stats) const;
+	void RecordGame(const GameOutcome& outcome);
+	void PlayPairings(const std::vector<std::pair<unsigned int, unsigned int>>& pairings, unsigned int gamesPerPair, unsigned int nThreads, uint64_t matchSeed);
+
+public:
+	Tournament(void);
+
+	void SetDisplay(bool bShowWinner, bool bShowMoveByMove, bool bShowMoveHistory, bool bShowGameNumber);
+	void SetMoveStats(bool bShowMoveStats, bool bPerMoveNumber = true, const std::string& csvFile = "");
+	bool SetGameRecordFile(const std::string& filename, bool bIndex = true);
+	void SetTimeControl(double baseSeconds, double incrementSeconds = 0.0);
+	bool HasTimeControl(void) const;
+
+	//
+	// Two-solver matches
+	//
+	int PlayTwoSolvers(Solver_ConnectFour* p1, Solver_ConnectFour* p2, std::ostream& out = std::cout, const std::string& opening = "", GameOutcome* record = nullptr);
+	void MatchPlay(Solver_ConnectFour* p1, Solver_ConnectFour* p2, unsigned int numberOfGames = 1, unsigned int nThreads = 0, uint64_t matchSeed = 0);
+	void OpeningMatchPlay(Solver_ConnectFour* p1, Solver_ConnectFour* p2, const std::vector<std::string>& openings, unsigned int nThreads = 0, uint64_t matchSeed = 0);
+	t_SPRTStatus SPRTMatchPlay(Solver_ConnectFour* p1, Solver_ConnectFour* p2, SPRT test, unsigned int maxGames, 
+		const std::vector<std::string>& openings = std::vector<std::string>(), unsigned int nThreads = 0, uint64_t matchSeed = 0);
+
+	static bool LoadOpenings(const std::string& filename, std::vector<std::string>& openings);
+
+	//
+	// Multi-solver tournaments
+	//
+	void AddSolver(Solver_ConnectFour* p);
+	void SetOpenings(const std::vector<std::string>& openings);
+	void SetResultsFile(const std::string& filename, t_ResultsFormat format = RESULTS_CSV);
+	void RoundRobin(unsigned int gamesPerPair, unsigned int nThreads = 0, uint64_t matchSeed = 0);
+	void Gauntlet(unsigned int gamesPerPair, unsigned int nThreads = 0, uint64_t matchSeed = 0);
+};